@@ -0,0 +1,415 @@
+/**
+ * Benchmarks for the tree library.
+ *
+ * Build with `make bench`. Wall-clock times are printed per scenario; run the
+ * binary under `perf stat -e cache-misses` to see the cache behaviour directly.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+#include "sources/Node.h"
+#include "sources/Tree.h"
+#include "sources/KaryHeap.h"
+#include "sources/CowTree.h"
+#include <functional>
+#include <queue>
+using namespace std;
+
+template<typename F>
+static double time_ms(F &&work) {
+    auto start = chrono::steady_clock::now();
+    work();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void report(const string &name, double ms) {
+    cout << "  " << name << ": " << ms << " ms" << endl;
+}
+
+/**
+ * Builds a complete binary tree level by level, so nodes are allocated in BFS order.
+ */
+static void build_complete(Tree<long> &tree, int levels) {
+    Node<long> root_node(0);
+    tree.add_root(root_node);
+    vector<Node<long> *> level{tree.root.get()};
+    long value = 1;
+    for (int depth = 1; depth < levels; ++depth) {
+        vector<Node<long> *> next;
+        next.reserve(level.size() * 2);
+        for (auto *node : level) {
+            next.push_back(tree.add_child(node, value++));
+            next.push_back(tree.add_child(node, value++));
+        }
+        level = move(next);
+    }
+}
+
+/**
+ * Builds a complete binary tree whose nodes are created in a random order,
+ * parents before children, so neighbours in any traversal lie far apart in storage.
+ */
+static void build_scattered(Tree<long> &tree, int levels) {
+    Node<long> root_node(0);
+    tree.add_root(root_node);
+    mt19937 rng(7);
+    vector<pair<Node<long> *, int>> open{{tree.root.get(), 1}};
+    long value = 1;
+    while (!open.empty()) {
+        size_t pick = rng() % open.size();
+        auto [parent, depth] = open[pick];
+        auto *child = tree.add_child(parent, value++);
+        if (parent->numOfChildren == 2) {
+            open[pick] = open.back();
+            open.pop_back();
+        }
+        if (depth + 1 < levels) open.emplace_back(child, depth + 1);
+    }
+}
+
+/**
+ * Sums the values in pre-order over raw child pointers, so the time is dominated
+ * by touching the nodes rather than by iterator bookkeeping.
+ */
+static long preorder_sum(const Tree<long> &tree) {
+    long sum = 0;
+    vector<const Node<long> *> pending;
+    if (tree.root) pending.push_back(tree.root.get());
+    while (!pending.empty()) {
+        const Node<long> *node = pending.back();
+        pending.pop_back();
+        sum += node->data;
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+            if (*it) pending.push_back(it->get());
+        }
+    }
+    return sum;
+}
+
+/**
+ * Sums the values in level order over raw child pointers.
+ */
+static long bfs_sum(const Tree<long> &tree) {
+    long sum = 0;
+    vector<const Node<long> *> queue;
+    queue.reserve(tree.size());
+    if (tree.root) queue.push_back(tree.root.get());
+    for (size_t i = 0; i < queue.size(); ++i) {
+        sum += queue[i]->data;
+        for (const auto &child : queue[i]->children) {
+            if (child) queue.push_back(child.get());
+        }
+    }
+    return sum;
+}
+
+static long random_descents(Tree<long> &tree, int walks) {
+    mt19937 rng(42);
+    long sum = 0;
+    for (int i = 0; i < walks; ++i) {
+        const Node<long> *node = tree.root.get();
+        while (node) {
+            sum += node->data;
+            const Node<long> *next = nullptr;
+            if (node->numOfChildren > 0) {
+                auto pick = rng() % static_cast<unsigned>(node->numOfChildren);
+                for (const auto &child : node->children) {
+                    if (child && pick-- == 0) {
+                        next = child.get();
+                        break;
+                    }
+                }
+            }
+            node = next;
+        }
+    }
+    return sum;
+}
+
+static void bench_layout() {
+    const int levels = 20;
+    const int walks = 200000;
+    Tree<long> tree;
+    build_scattered(tree, levels);
+    long sink = 0;
+
+    cout << "Layout (" << ((1L << levels) - 1) << " nodes, allocated in random order)" << endl;
+    report("preorder scan, scattered storage", time_ms([&] { sink += preorder_sum(tree); }));
+    report("BFS scan, scattered storage", time_ms([&] { sink += bfs_sum(tree); }));
+    report("root-to-leaf walks, scattered storage", time_ms([&] { sink += random_descents(tree, walks); }));
+
+    tree.compact(Layout::Preorder);
+    report("preorder scan, preorder storage", time_ms([&] { sink += preorder_sum(tree); }));
+    report("BFS scan, preorder storage", time_ms([&] { sink += bfs_sum(tree); }));
+
+    tree.compact(Layout::BFS);
+    report("preorder scan, BFS storage", time_ms([&] { sink += preorder_sum(tree); }));
+    report("BFS scan, BFS storage", time_ms([&] { sink += bfs_sum(tree); }));
+    report("root-to-leaf walks, BFS storage", time_ms([&] { sink += random_descents(tree, walks); }));
+
+    tree.compact(Layout::VanEmdeBoas);
+    report("root-to-leaf walks, vEB storage", time_ms([&] { sink += random_descents(tree, walks); }));
+
+    auto frozen = tree.freeze();
+    report("preorder scan, frozen", time_ms([&] {
+        for (auto it = frozen.begin_preorder(); it.has_next();) sink += it.next();
+    }));
+    report("BFS scan, frozen", time_ms([&] {
+        for (auto it = frozen.begin_bfs(); it.has_next();) sink += it.next();
+    }));
+
+    cout << "  (checksum " << sink << ")" << endl;
+}
+
+/**
+ * What callers had to do before parent links: search from the root, tracking the path.
+ */
+static bool search_path(const Node<long> *node, long value, vector<const Node<long> *> &path) {
+    path.push_back(node);
+    if (node->data == value) return true;
+    for (const auto &child : node->children) {
+        if (child && search_path(child.get(), value, path)) return true;
+    }
+    path.pop_back();
+    return false;
+}
+
+static void bench_ancestors() {
+    const int levels = 16;
+    const int queries = 2000;
+    Tree<long> tree;
+    build_complete(tree, levels);
+    const long count = (1L << levels) - 1;
+
+    mt19937 rng(7);
+    vector<long> targets;
+    vector<Node<long> *> handles;
+    for (int i = 0; i < queries; ++i) {
+        targets.push_back(static_cast<long>(rng() % static_cast<unsigned>(count)));
+        handles.push_back(tree.find(targets.back()));
+    }
+    size_t sink = 0;
+
+    cout << "Ancestors (" << count << " nodes, " << queries << " queries)" << endl;
+    report("search-based path reconstruction", time_ms([&] {
+        vector<const Node<long> *> path;
+        for (long target : targets) {
+            path.clear();
+            search_path(tree.root.get(), target, path);
+            sink += path.size();
+        }
+    }));
+    report("path_to_root via parent links", time_ms([&] {
+        for (auto *handle : handles) sink += tree.path_to_root(handle).size();
+    }));
+    report("depth via parent links", time_ms([&] {
+        for (auto *handle : handles) sink += static_cast<size_t>(tree.depth(handle));
+    }));
+
+    cout << "  (checksum " << sink << ")" << endl;
+}
+
+static void bench_range_query() {
+    const int levels = 18;
+    Tree<double> tree;
+    Node<double> root_node(0.0);
+    tree.add_root(root_node);
+    vector<Node<double> *> level{tree.root.get()};
+    // Values grow with pre-order-ish position, so each subtree holds a narrow, clustered range.
+    for (int depth = 1; depth < levels; ++depth) {
+        vector<Node<double> *> next;
+        for (auto *node : level) {
+            double spread = static_cast<double>(1L << (levels - depth));
+            next.push_back(tree.add_child(node, node->data + 1.0));
+            next.push_back(tree.add_child(node, node->data + spread));
+        }
+        level = move(next);
+    }
+    tree.track_value_bounds();
+    size_t sink = 0;
+
+    cout << "Range query (" << tree.size() << " nodes, clustered values)" << endl;
+    report("full scan with find_all_if", time_ms([&] {
+        for (int i = 0; i < 20; ++i) {
+            double lo = i * 10000.0;
+            sink += tree.find_all_if([&](double value) { return value >= lo && value <= lo + 50.0; }).size();
+        }
+    }));
+    report("range_query with subtree bounds", time_ms([&] {
+        for (int i = 0; i < 20; ++i) {
+            double lo = i * 10000.0;
+            sink += tree.range_query(lo, lo + 50.0).size();
+        }
+    }));
+
+    cout << "  (checksum " << sink << ")" << endl;
+}
+
+/**
+ * Scheduler-style "hold" workload: repeatedly pop the earliest event and schedule a later one.
+ */
+template<int K>
+static long hold_kary(const vector<int> &initial, const vector<int> &delays) {
+    KaryHeap<int, K> heap(initial);
+    long sum = 0;
+    for (int delay : delays) {
+        int now = heap.top();
+        heap.pop();
+        heap.push(now + delay);
+        sum += now;
+    }
+    return sum;
+}
+
+static long hold_std(const vector<int> &initial, const vector<int> &delays) {
+    priority_queue<int, vector<int>, greater<>> heap(greater<>(), initial);
+    long sum = 0;
+    for (int delay : delays) {
+        int now = heap.top();
+        heap.pop();
+        heap.push(now + delay);
+        sum += now;
+    }
+    return sum;
+}
+
+static void bench_heap() {
+    const size_t pending = 1 << 20;
+    const size_t events = 4 << 20;
+    mt19937 rng(3);
+    vector<int> initial(pending);
+    for (auto &time : initial) time = static_cast<int>(rng() % 1000000);
+    vector<int> delays(events);
+    for (auto &delay : delays) delay = static_cast<int>(rng() % 1000);
+    long sink = 0;
+
+    cout << "Heap hold workload (" << pending << " pending, " << events << " events)" << endl;
+    report("std::priority_queue", time_ms([&] { sink += hold_std(initial, delays); }));
+    report("KaryHeap<int, 2>", time_ms([&] { sink += hold_kary<2>(initial, delays); }));
+    report("KaryHeap<int, 4>", time_ms([&] { sink += hold_kary<4>(initial, delays); }));
+    report("KaryHeap<int, 8>", time_ms([&] { sink += hold_kary<8>(initial, delays); }));
+
+    cout << "  (checksum " << sink << ")" << endl;
+}
+
+/**
+ * Builds the same 4-ary tree from shuffled (child, parent) pairs, once node by node and once in bulk.
+ */
+static void bench_bulk_build() {
+    const size_t small = 20000;
+    const size_t large = 4 << 20;
+    mt19937 rng(5);
+    auto make_edges = [&](size_t n) {
+        vector<pair<size_t, size_t>> edges;
+        edges.reserve(n - 1);
+        for (size_t i = 1; i < n; ++i) edges.emplace_back(i, (i - 1) / 4);
+        shuffle(edges.begin(), edges.end(), rng);
+        return edges;
+    };
+    vector<long> values(large);
+    for (size_t i = 0; i < large; ++i) values[i] = static_cast<long>(i);
+    auto small_edges = make_edges(small);
+    auto large_edges = make_edges(large);
+    size_t sink = 0;
+
+    cout << "Bulk construction (" << small << " and " << large << " nodes, shuffled edges)" << endl;
+    report("add_sub_node in parent order, small", time_ms([&] {
+        Tree<long, 4> tree;
+        Node<long> root_node(0);
+        tree.add_root(root_node);
+        for (size_t i = 1; i < small; ++i) {
+            Node<long> parent_node(static_cast<long>((i - 1) / 4));
+            Node<long> child_node(static_cast<long>(i));
+            tree.add_sub_node(parent_node, child_node);
+        }
+        sink += tree.size();
+    }));
+    report("from_edges, small", time_ms([&] {
+        sink += Tree<long, 4>::from_edges(span<const long>(values).first(small), small_edges).size();
+    }));
+    report("from_edges, large, 1 thread", time_ms([&] {
+        sink += Tree<long, 4>::from_edges(values, large_edges, 1).size();
+    }));
+    report("from_edges, large, all threads", time_ms([&] {
+        sink += Tree<long, 4>::from_edges(values, large_edges).size();
+    }));
+    report("from_level_order, large", time_ms([&] {
+        sink += Tree<long, 4>::from_level_order(values).size();
+    }));
+
+    cout << "  (checksum " << sink << ")" << endl;
+}
+
+/**
+ * Deep-copies a 4M-node tree and reports the clone rate.
+ */
+static void bench_clone() {
+    const size_t nodes = 4 << 20;
+    vector<long> values(nodes);
+    for (size_t i = 0; i < nodes; ++i) values[i] = static_cast<long>(i);
+    auto tree = Tree<long, 4>::from_level_order(values);
+    size_t sink = 0;
+
+    auto clone_rate = [&](const string &name, unsigned threads) {
+        double ms = time_ms([&] { sink += tree.clone(threads).size(); });
+        cout << "  " << name << ": " << ms << " ms, "
+             << static_cast<double>(nodes) / ms / 1000.0 << " M nodes/s (including teardown)" << endl;
+    };
+    cout << "Deep copy (" << nodes << " nodes)" << endl;
+    clone_rate("1 thread", 1);
+    clone_rate("all threads", 0);
+
+    cout << "  (checksum " << sink << ")" << endl;
+}
+
+/**
+ * Takes many copies of one baseline tree and changes a single deep node in each.
+ */
+static void bench_copy_on_write() {
+    const size_t nodes = 1 << 16;
+    const int copies = 200;
+    vector<long> values(nodes);
+    for (size_t i = 0; i < nodes; ++i) values[i] = static_cast<long>(i);
+    auto baseline = Tree<long, 4>::from_level_order(values);
+    CowTree<long, 4> shared(baseline);
+    const CowTree<long, 4>::Path deep{3, 1, 2, 0, 3, 1, 2};
+    long sink = 0;
+
+    cout << "Copy and change one node (" << nodes << " nodes, " << copies << " copies)" << endl;
+    report("deep copies", time_ms([&] {
+        vector<Tree<long, 4>> kept;
+        for (int i = 0; i < copies; ++i) {
+            kept.push_back(baseline);
+            Node<long> *node = kept.back().root.get();
+            for (size_t step : deep) node = node->children[step].get();
+            kept.back().set_data(node, i);
+            sink += node->data;
+        }
+    }));
+    report("copy-on-write", time_ms([&] {
+        vector<CowTree<long, 4>> kept;
+        for (int i = 0; i < copies; ++i) {
+            kept.push_back(shared);
+            kept.back().set_data(deep, i);
+            sink += kept.back().get(deep);
+        }
+    }));
+
+    cout << "  (checksum " << sink << ")" << endl;
+}
+
+int main() {
+    bench_layout();
+    bench_ancestors();
+    bench_range_query();
+    bench_heap();
+    bench_bulk_build();
+    bench_clone();
+    bench_copy_on_write();
+    return 0;
+}
@@ -1,6 +1,16 @@
 #include "doctest.h"
 #include "Node.h"
 #include "Tree.h"
+#include "ImplicitTree.h"
+#include "LcaIndex.h"
+#include "SubtreeIndex.h"
+#include "HeavyLightIndex.h"
+#include "OrderedTree.h"
+#include "KaryHeap.h"
+#include "CowTree.h"
+#include "PersistentTree.h"
+#include <random>
+#include <string>
 
 // Initialization and Basic Operations
 
@@ -153,7 +163,7 @@ TEST_CASE("Test In-Order Traversal on Single Node Tree") {
     Tree<int> tree;
     Node<int> root_node(1);
     tree.add_root(root_node);
-    auto it = tree.begin_inorder();
+    Tree<int>::InOrderIterator it = tree.begin_inorder();
     CHECK(it.has_next());
     CHECK(it.next() == 1);
     CHECK_FALSE(it.has_next());
@@ -324,7 +334,7 @@ TEST_CASE("Test Deep Copy of Tree") {
     CHECK(tree_copy.root->children[0]->data == 2);
 
     tree_copy.root->data = 3;
-    CHECK_FALSE(tree.root->data == 1); // Ensure original tree is not affected
+    CHECK(tree.root->data == 1); // Ensure original tree is not affected
 }
 
 TEST_CASE("Test Move of Tree") {
@@ -337,7 +347,7 @@ TEST_CASE("Test Move of Tree") {
     Tree<int> moved_tree = std::move(tree);
     CHECK(moved_tree.root->data == 1);
     CHECK(moved_tree.root->children[0]->data == 2);
-    CHECK_FALSE(tree.root == nullptr); // Original tree should be empty
+    CHECK(tree.root == nullptr); // Original tree should be empty
 }
 
 // Edge Cases
@@ -418,3 +428,1458 @@ TEST_CASE("Test Multiple Levels of Depth") {
     CHECK_FALSE(it.has_next());
 }
 
+
+// Memory Layout
+
+TEST_CASE("Test Add Child by Handle") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *child = tree.add_child(tree.root.get(), 2);
+    tree.add_child(child, 3);
+    CHECK(tree.root->children[0]->data == 2);
+    CHECK(child->numOfChildren == 1);
+    CHECK_THROWS_AS(tree.add_child(nullptr, 4), std::invalid_argument);
+}
+
+TEST_CASE("Test Compact Keeps Structure") {
+    for (Layout layout : {Layout::Preorder, Layout::BFS, Layout::VanEmdeBoas}) {
+        Tree<int> tree;
+        Node<int> root_node(1);
+        tree.add_root(root_node);
+        auto *left = tree.add_child(tree.root.get(), 2);
+        auto *right = tree.add_child(tree.root.get(), 3);
+        tree.add_child(left, 4);
+        tree.add_child(left, 5);
+        tree.add_child(right, 6);
+
+        tree.compact(layout);
+
+        std::vector<int> values;
+        for (auto it = tree.begin_preorder(); it.has_next();) {
+            values.push_back(it.next());
+        }
+        CHECK(values == std::vector<int>{1, 2, 4, 5, 3, 6});
+    }
+}
+
+TEST_CASE("Test Compact Preorder Places Nodes Sequentially") {
+    Tree<int> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> level{tree.root.get()};
+    int value = 1;
+    for (int depth = 0; depth < 4; ++depth) {
+        std::vector<Node<int> *> next;
+        for (auto *node : level) {
+            next.push_back(tree.add_child(node, value++));
+            next.push_back(tree.add_child(node, value++));
+        }
+        level = next;
+    }
+
+    tree.compact(Layout::Preorder);
+
+    std::vector<const Node<int> *> order;
+    std::stack<const Node<int> *> pending;
+    pending.push(tree.root.get());
+    while (!pending.empty()) {
+        auto *node = pending.top();
+        pending.pop();
+        order.push_back(node);
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+            if (*it) pending.push(it->get());
+        }
+    }
+    CHECK(order.size() == 31);
+    CHECK(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST_CASE("Test Compact Deep Chain") {
+    Tree<int, 1> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    Node<int> *tail = tree.root.get();
+    for (int i = 1; i < 300000; ++i) tail = tree.add_child(tail, i);
+
+    tree.compact(Layout::Preorder);
+
+    CHECK(tree.size() == 300000);
+    const Node<int> *node = tree.root.get();
+    int length = 1;
+    while (!node->children.empty()) {
+        node = node->children[0].get();
+        ++length;
+    }
+    CHECK(length == 300000);
+    CHECK(node->data == 299999);
+}
+
+// Implicit Trees
+
+template<typename Iterator>
+static std::vector<int> drain(Iterator it) {
+    std::vector<int> values;
+    while (it.has_next()) values.push_back(it.next());
+    return values;
+}
+
+TEST_CASE("Test Implicit Tree Traversals Match Pointer Tree") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> nodes{tree.root.get()};
+    ImplicitTree<int, 3> implicit({0});
+    for (int value = 1; value < 11; ++value) {
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(value - 1) / 3], value));
+        implicit.push_back(value);
+    }
+
+    CHECK(drain(implicit.begin_preorder()) == drain(tree.begin_preorder()));
+    CHECK(drain(implicit.begin_postorder()) == drain(tree.begin_postorder()));
+    CHECK(drain(implicit.begin_bfs()) == drain(tree.begin_bfs()));
+    CHECK(drain(implicit.begin_dfs()) == drain(tree.begin_dfs()));
+    CHECK(drain(implicit.begin_heap()) == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+}
+
+TEST_CASE("Test Implicit Tree In-Order Traversal") {
+    ImplicitTree<int> tree({1, 2, 3, 4, 5, 6});
+    CHECK(drain(tree.begin_inorder()) == std::vector<int>{4, 2, 5, 1, 6, 3});
+    CHECK(drain(ImplicitTree<int>().begin_inorder()).empty());
+}
+
+TEST_CASE("Test Implicit Tree Navigation and Levels") {
+    ImplicitTree<int, 4> tree({0, 1, 2, 3, 4, 5, 6, 7});
+    CHECK(tree.child(0, 3) == 4);
+    CHECK(tree.child(1, 2) == 7);
+    CHECK(tree.child(1, 3) == ImplicitTree<int, 4>::npos);
+    CHECK(ImplicitTree<int, 4>::parent(7) == 1);
+    CHECK(tree.num_children(1) == 3);
+    CHECK(tree.levels() == 3);
+    CHECK(tree.level(1).size() == 4);
+    CHECK(tree.level(2)[0] == 5);
+    CHECK_THROWS_AS((void) tree.level(3), std::out_of_range);
+
+    auto leaf = tree.descend([](size_t, std::span<const int> children) {
+        return static_cast<size_t>(std::max_element(children.begin(), children.end()) - children.begin());
+    });
+    CHECK(leaf == 4);
+}
+
+// Binary Trees
+
+TEST_CASE("Test Binary Tree Left and Right Links") {
+    Tree<int> tree;
+    Node<int> root_node(1);
+    Node<int> child_node1(2);
+    Node<int> child_node2(3);
+    tree.add_root(root_node);
+    tree.add_sub_node(root_node, child_node1);
+    CHECK(tree.root->left()->data == 2);
+    CHECK(tree.root->right() == nullptr);
+    tree.add_sub_node(root_node, child_node2);
+    CHECK(tree.root->right()->data == 3);
+    CHECK(tree.root->side(false) == tree.root->left());
+    CHECK(tree.root->side(true) == tree.root->right());
+}
+
+TEST_CASE("Test Binary In-Order Traversal on Deeper Tree") {
+    Tree<int> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *left = tree.add_child(tree.root.get(), 2);
+    auto *right = tree.add_child(tree.root.get(), 3);
+    tree.add_child(left, 4);
+    tree.add_child(left, 5);
+    tree.add_child(right, 6);
+
+    CHECK(drain(tree.begin_inorder()) == std::vector<int>{4, 2, 5, 1, 6, 3});
+    CHECK(drain(tree.begin_inorder()) == drain(ImplicitTree<int>({1, 2, 3, 4, 5, 6}).begin_inorder()));
+
+    tree.compact(Layout::VanEmdeBoas);
+    CHECK(drain(tree.begin_inorder()) == std::vector<int>{4, 2, 5, 1, 6, 3});
+}
+
+TEST_CASE("Test K-ary In-Order Traversal on Deeper Tree") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *first = tree.add_child(tree.root.get(), 2);
+    tree.add_child(tree.root.get(), 3);
+    tree.add_child(first, 4);
+    tree.add_child(first, 5);
+
+    CHECK(drain(tree.begin_inorder()) == std::vector<int>{4, 2, 5, 1, 3});
+}
+
+// Stackless Traversal
+
+TEST_CASE("Test Parent Links") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    Node<int> child_node(2);
+    tree.add_root(root_node);
+    tree.add_sub_node(root_node, child_node);
+    auto *grandchild = tree.add_child(tree.root->children[0].get(), 3);
+    CHECK(tree.root->parent == nullptr);
+    CHECK(tree.root->children[0]->parent == tree.root.get());
+    CHECK(grandchild->parent == tree.root->children[0].get());
+
+    tree.compact(Layout::BFS);
+    CHECK(tree.root->children[0]->children[0]->parent == tree.root->children[0].get());
+}
+
+template<int K>
+static void check_stackless_matches(Tree<int, K> &tree) {
+    CHECK(drain(tree.begin_preorder_stackless()) == drain(tree.begin_preorder()));
+    CHECK(drain(tree.begin_postorder_stackless()) == drain(tree.begin_postorder()));
+    CHECK(drain(tree.begin_inorder_stackless()) == drain(tree.begin_inorder()));
+}
+
+TEST_CASE("Test Stackless Traversals Match Iterators") {
+    Tree<int> empty;
+    check_stackless_matches(empty);
+
+    Tree<int> binary;
+    Node<int> root_node(1);
+    binary.add_root(root_node);
+    auto *left = binary.add_child(binary.root.get(), 2);
+    auto *right = binary.add_child(binary.root.get(), 3);
+    binary.add_child(binary.add_child(left, 4), 7);
+    binary.add_child(left, 5);
+    binary.add_child(right, 6);
+    check_stackless_matches(binary);
+
+    Tree<int, 4> wide;
+    wide.add_root(root_node);
+    std::vector<Node<int> *> nodes{wide.root.get()};
+    for (int value = 2; value < 30; ++value) {
+        nodes.push_back(wide.add_child(nodes[static_cast<size_t>(value / 3)], value));
+    }
+    check_stackless_matches(wide);
+}
+
+// Upward Navigation
+
+TEST_CASE("Test Ancestors, Depth and Path to Root") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *child = tree.add_child(tree.root.get(), 2);
+    auto *grandchild = tree.add_child(child, 3);
+    tree.add_child(tree.root.get(), 4);
+
+    CHECK(tree.find(3) == grandchild);
+    CHECK(tree.find(9) == nullptr);
+    CHECK(tree.depth(tree.root.get()) == 0);
+    CHECK(tree.depth(grandchild) == 2);
+    CHECK(tree.ancestors(grandchild) == std::vector<Node<int> *>{child, tree.root.get()});
+    CHECK(tree.ancestors(tree.root.get()).empty());
+    CHECK(tree.path_to_root(grandchild) == std::vector<Node<int> *>{grandchild, child, tree.root.get()});
+    CHECK_THROWS_AS((void) tree.depth(nullptr), std::invalid_argument);
+}
+
+// Lowest Common Ancestor
+
+TEST_CASE("Test LCA Index Queries") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *a = tree.add_child(tree.root.get(), 2);
+    auto *b = tree.add_child(tree.root.get(), 3);
+    auto *c = tree.add_child(a, 4);
+    auto *d = tree.add_child(a, 5);
+    auto *e = tree.add_child(c, 6);
+    auto *f = tree.add_child(b, 7);
+
+    LcaIndex<int, 3> index(tree);
+    CHECK(index.lca(e, d) == a);
+    CHECK(index.lca(e, f) == tree.root.get());
+    CHECK(index.lca(c, e) == c);
+    CHECK(index.lca(f, f) == f);
+    CHECK(index.lca(6, 5) == a);
+    CHECK(index.depth(e) == 3);
+    CHECK_THROWS_AS((void) index.lca(8, 5), std::invalid_argument);
+
+    Tree<int, 3> other;
+    other.add_root(root_node);
+    CHECK_THROWS_AS((void) index.lca(other.root.get(), e), std::invalid_argument);
+
+    std::vector<LcaIndex<int, 3>::NodePair> queries{{d, c}, {f, b}, {e, tree.root.get()}};
+    CHECK(index.lca_batch(queries) == std::vector<Node<int> *>{a, b, tree.root.get()});
+}
+
+TEST_CASE("Test LCA Index Matches Ancestor Walk") {
+    Tree<int, 4> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> nodes{tree.root.get()};
+    for (int value = 1; value < 60; ++value) {
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(value / 3)], value));
+    }
+
+    LcaIndex<int, 4> index(tree);
+    int mismatches = 0;
+    for (auto *x : nodes) {
+        auto path = tree.path_to_root(x);
+        for (auto *y : nodes) {
+            Node<int> *expected = y;
+            while (std::find(path.begin(), path.end(), expected) == path.end()) expected = expected->parent;
+            if (index.lca(x, y) != expected) ++mismatches;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+// Subtree Aggregates
+
+TEST_CASE("Test Segment Tree Range Summaries") {
+    SegmentTree<int> segments({5, 3, 8, 1, 9, 2, 7});
+    auto all = segments.query(0, 7);
+    CHECK(all.sum == 35);
+    CHECK(all.min == 1);
+    CHECK(all.max == 9);
+    CHECK(all.count == 7);
+    CHECK(segments.query(2, 5).sum == 18);
+    CHECK(segments.query(5, 6).max == 2);
+    segments.update(3, 10);
+    CHECK(segments.query(1, 4).max == 10);
+    CHECK(segments.query(1, 4).min == 3);
+    CHECK_THROWS_AS((void) segments.query(4, 4), std::out_of_range);
+}
+
+TEST_CASE("Test Subtree Index Queries and Updates") {
+    Tree<int, 3> tree;
+    Node<int> root_node(10);
+    tree.add_root(root_node);
+    auto *a = tree.add_child(tree.root.get(), 4);
+    auto *b = tree.add_child(tree.root.get(), 7);
+    auto *c = tree.add_child(a, 1);
+    tree.add_child(a, 6);
+    tree.add_child(c, 2);
+    tree.add_child(b, 9);
+
+    SubtreeIndex<int, 3> index(tree);
+    CHECK(index.subtree_sum(tree.root.get()) == 39);
+    CHECK(index.subtree_sum(a) == 13);
+    CHECK(index.subtree_min(a) == 1);
+    CHECK(index.subtree_max(a) == 6);
+    CHECK(index.subtree_count(a) == 4);
+    CHECK(index.subtree_count(c) == 2);
+    CHECK(index.subtree_max(b) == 9);
+
+    index.set_data(c, 20);
+    CHECK(c->data == 20);
+    CHECK(index.subtree_sum(a) == 32);
+    CHECK(index.subtree_max(tree.root.get()) == 20);
+    CHECK(index.subtree_max(b) == 9);
+
+    Tree<int, 3> other;
+    other.add_root(root_node);
+    CHECK_THROWS_AS((void) index.subtree_sum(other.root.get()), std::invalid_argument);
+}
+
+// Path Aggregates
+
+TEST_CASE("Test Heavy-Light Path Queries") {
+    Tree<int, 3> tree;
+    Node<int> root_node(5);
+    tree.add_root(root_node);
+    auto *a = tree.add_child(tree.root.get(), 3);
+    auto *b = tree.add_child(tree.root.get(), 8);
+    auto *c = tree.add_child(a, 1);
+    auto *d = tree.add_child(a, 9);
+    auto *e = tree.add_child(c, 4);
+    auto *f = tree.add_child(b, 2);
+
+    HeavyLightIndex<int, 3> index(tree);
+    CHECK(index.path_sum(e, f) == 4 + 1 + 3 + 5 + 8 + 2);
+    CHECK(index.path_max(e, d) == 9);
+    CHECK(index.path_min(d, b) == 3);
+    CHECK(index.path(e, f).count == 6);
+    CHECK(index.path_sum(c, c) == 1);
+    CHECK(index.path_from_root(e).sum == 13);
+
+    index.set_data(a, 20);
+    CHECK(a->data == 20);
+    CHECK(index.path_max(e, f) == 20);
+    CHECK(index.path_sum(d, tree.root.get()) == 34);
+    CHECK(index.path_max(b, f) == 8);
+
+    HeavyLightIndex<int, 3> empty{Tree<int, 3>()};
+    CHECK_THROWS_AS(empty.path_from_root(e), std::invalid_argument);
+}
+
+TEST_CASE("Test Heavy-Light Path Sums Match Ancestor Walk") {
+    Tree<int, 2> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> nodes{tree.root.get()};
+    for (int value = 1; value < 40; ++value) {
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(value < 20 ? value - 1 : value - 20)], value));
+    }
+    HeavyLightIndex<int, 2> index(tree);
+    LcaIndex<int, 2> lca(tree);
+
+    int mismatches = 0;
+    for (auto *x : nodes) {
+        for (auto *y : nodes) {
+            auto *meet = lca.lca(x, y);
+            int expected = meet->data;
+            for (auto *up = x; up != meet; up = up->parent) expected += up->data;
+            for (auto *up = y; up != meet; up = up->parent) expected += up->data;
+            if (index.path_sum(x, y) != expected) ++mismatches;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+// Size and Height
+
+TEST_CASE("Test Size and Height") {
+    Tree<int> tree;
+    CHECK(tree.size() == 0);
+    CHECK(tree.height() == -1);
+
+    Node<int> root_node(1);
+    Node<int> child_node(2);
+    Node<int> grandchild_node(3);
+    tree.add_root(root_node);
+    CHECK(tree.size() == 1);
+    CHECK(tree.height() == 0);
+    tree.add_sub_node(root_node, child_node);
+    tree.add_sub_node(child_node, grandchild_node);
+    tree.add_child(tree.root.get(), 4);
+    CHECK(tree.size() == 4);
+    CHECK(tree.height() == 2);
+    CHECK(tree.find(3)->depth == 2);
+    CHECK(tree.depth(tree.find(4)) == 1);
+}
+
+TEST_CASE("Test Subtree Sizes and Pre-Order Rank") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    auto *a = tree.add_child(tree.root.get(), 1);
+    tree.add_child(a, 2);
+    CHECK_THROWS_AS((void) tree.node_at(0), std::logic_error);
+
+    tree.track_subtree_sizes();
+    CHECK(tree.root->subtree_size == 3);
+    auto *b = tree.add_child(tree.root.get(), 3);
+    tree.add_child(b, 4);
+    tree.add_child(a, 5);
+    CHECK(tree.root->subtree_size == 6);
+    CHECK(a->subtree_size == 3);
+
+    std::vector<int> ranked;
+    for (size_t rank = 0; rank < tree.size(); ++rank) ranked.push_back(tree.node_at(rank)->data);
+    CHECK(ranked == drain(tree.begin_preorder()));
+    CHECK_THROWS_AS((void) tree.node_at(6), std::out_of_range);
+}
+
+// Random Sampling
+
+TEST_CASE("Test Fenwick Tree Prefix Search") {
+    FenwickTree<int> sums({3, 0, 2, 5, 1});
+    CHECK(sums.total() == 11);
+    CHECK(sums.prefix(3) == 5);
+    CHECK(sums.upper_bound(0) == 0);
+    CHECK(sums.upper_bound(3) == 2);
+    CHECK(sums.upper_bound(5) == 3);
+    CHECK(sums.upper_bound(10) == 4);
+    CHECK(sums.upper_bound(11) == 5);
+    sums.add(1, 4);
+    CHECK(sums.upper_bound(3) == 1);
+}
+
+TEST_CASE("Test Uniform Node Sampling") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> nodes{tree.root.get()};
+    for (int value = 1; value < 12; ++value) {
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(value - 1) / 3], value));
+    }
+
+    std::mt19937 rng(1);
+    auto picks = tree.sample(3000, rng);
+    CHECK(picks.size() == 3000);
+    std::vector<int> hits(12, 0);
+    for (auto *node : picks) ++hits[static_cast<size_t>(node->data)];
+    CHECK(*std::min_element(hits.begin(), hits.end()) > 150);
+    CHECK(tree.sample(0, rng).empty());
+
+    Tree<int> empty;
+    CHECK_THROWS_AS((void) empty.sample(1, rng), std::out_of_range);
+}
+
+TEST_CASE("Test Value-Weighted Node Sampling") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    auto *light = tree.add_child(tree.root.get(), 1);
+    auto *heavy = tree.add_child(tree.root.get(), 9);
+    SubtreeIndex<int, 3> index(tree);
+
+    std::mt19937 rng(2);
+    auto picks = index.sample_weighted(1000, rng);
+    CHECK(std::count(picks.begin(), picks.end(), tree.root.get()) == 0);
+    CHECK(std::count(picks.begin(), picks.end(), heavy) > 800);
+
+    index.set_data(heavy, 0);
+    picks = index.sample_weighted(20, rng);
+    CHECK(std::count(picks.begin(), picks.end(), light) == 20);
+}
+
+// Predicate Search
+
+TEST_CASE("Test Find If With Early Exit and Pruning") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *a = tree.add_child(tree.root.get(), 2);
+    auto *b = tree.add_child(tree.root.get(), 3);
+    tree.add_child(a, 4);
+    auto *c = tree.add_child(b, 6);
+    tree.add_child(a, 8);
+
+    int visited = 0;
+    CHECK(tree.find_if([&](int value) { ++visited; return value % 2 == 0; }) == a);
+    CHECK(visited == 2);
+    CHECK(tree.find_if([](int value) { return value > 100; }) == nullptr);
+    CHECK(tree.find_if([](int value) { return value % 2 == 0; },
+                       [&](const Node<int> &node) { return &node == a; }) == c);
+
+    auto evens = tree.find_all_if([](int value) { return value % 2 == 0; });
+    CHECK(evens.size() == 4);
+    CHECK(evens.front() == a);
+    CHECK(tree.find_all_if([](int) { return true; },
+                           [](const Node<int> &node) { return node.depth > 1; }).size() == 3);
+
+    Tree<int> empty;
+    CHECK(empty.find_if([](int) { return true; }) == nullptr);
+}
+
+TEST_CASE("Test Parallel Find If") {
+    Tree<int, 4> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> nodes{tree.root.get()};
+    for (int value = 1; value < 5000; ++value) {
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(value - 1) / 4], value));
+    }
+
+    CHECK(tree.find_if_parallel([](int value) { return value == 4321; }, Tree<int, 4>::NoPrune{}, 4) == nodes[4321]);
+    CHECK(tree.find_if_parallel([](int value) { return value == 2; }) == nodes[2]);
+    CHECK(tree.find_if_parallel([](int value) { return value < 0; }, Tree<int, 4>::NoPrune{}, 3) == nullptr);
+    CHECK(tree.find_if_parallel([](int value) { return value == 4321; },
+                                [&](const Node<int> &node) { return &node == nodes[1080]; }, 4) == nullptr);
+
+    std::atomic<int> visited{0};
+    auto *hit = tree.find_if_parallel([&](int value) { ++visited; return value >= 100; }, Tree<int, 4>::NoPrune{}, 4);
+    CHECK(hit != nullptr);
+    CHECK(hit->data >= 100);
+    CHECK(visited.load() < 5000);
+}
+
+// Batched Lookup
+
+TEST_CASE("Test Find Many Resolves in Input Order") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *a = tree.add_child(tree.root.get(), 2);
+    auto *b = tree.add_child(tree.root.get(), 3);
+    auto *c = tree.add_child(a, 3);
+    tree.add_child(c, 4);
+
+    std::vector<int> wanted{4, 3, 9, 1, 3};
+    auto hits = tree.find_many(wanted);
+    CHECK(hits == std::vector<Node<int> *>{c->children[0].get(), c, nullptr, tree.root.get(), c});
+    CHECK(hits[1] == tree.find(3));
+    CHECK(hits[1] != b);
+    CHECK(tree.find_many(std::vector<int>{}).empty());
+}
+
+TEST_CASE("Test Find Many With Ordered Non-Hashable Values") {
+    struct Key {
+        int id;
+
+        bool operator==(const Key &other) const { return id == other.id; }
+        bool operator<(const Key &other) const { return id < other.id; }
+    };
+
+    Tree<Key> tree;
+    Node<Key> root_node(Key{5});
+    tree.add_root(root_node);
+    auto *left = tree.add_child(tree.root.get(), Key{7});
+    tree.add_child(tree.root.get(), Key{7});
+    auto *deep = tree.add_child(left, Key{1});
+
+    std::vector<Key> wanted{{1}, {7}, {2}, {1}};
+    CHECK(tree.find_many(wanted) == std::vector<Node<Key> *>{deep, left, nullptr, deep});
+}
+
+// Range Queries
+
+TEST_CASE("Test Value Bounds Follow Insertions and Updates") {
+    Tree<double> tree;
+    Node<double> root_node(5.0);
+    tree.add_root(root_node);
+    auto *left = tree.add_child(tree.root.get(), 2.0);
+    tree.track_value_bounds();
+    CHECK(tree.root->bounds.min == 2.0);
+    CHECK(tree.root->bounds.max == 5.0);
+
+    auto *deep = tree.add_child(left, 9.5);
+    CHECK(left->bounds.max == 9.5);
+    CHECK(tree.root->bounds.max == 9.5);
+
+    tree.set_data(deep, 3.0);
+    CHECK(left->bounds.max == 3.0);
+    CHECK(tree.root->bounds.max == 5.0);
+    CHECK(deep->data == 3.0);
+    tree.set_data(tree.root.get(), 1.0);
+    CHECK(tree.root->bounds.min == 1.0);
+    CHECK(tree.root->bounds.max == 3.0);
+}
+
+TEST_CASE("Test Range Query Matches Full Scan") {
+    Tree<double, 3> tree;
+    Node<double> root_node(0.0);
+    tree.add_root(root_node);
+    CHECK_THROWS_AS((void) tree.range_query(0.0, 1.0), std::logic_error);
+    tree.track_value_bounds();
+
+    std::vector<Node<double> *> nodes{tree.root.get()};
+    for (int i = 1; i < 200; ++i) {
+        double value = (i % 7) * 100.0 + i * 0.5;
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(i - 1) / 3], value));
+    }
+
+    for (auto [lo, hi] : std::vector<std::pair<double, double>>{{0, 50}, {210, 260}, {-5, -1}, {0, 1000}}) {
+        auto expected = tree.find_all_if([&](double value) { return value >= lo && value <= hi; });
+        CHECK(tree.range_query(lo, hi) == expected);
+    }
+}
+
+// Membership Filters
+
+TEST_CASE("Test Bloom Filter Has No False Negatives") {
+    BloomFilter<std::string> filter(100, BloomFilter<std::string>::bits_per_item_for(0.01));
+    for (int i = 0; i < 100; ++i) filter.insert("id-" + std::to_string(i));
+    int false_negatives = 0;
+    int false_positives = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (!filter.might_contain("id-" + std::to_string(i))) ++false_negatives;
+        if (filter.might_contain("other-" + std::to_string(i))) ++false_positives;
+    }
+    CHECK(false_negatives == 0);
+    CHECK(false_positives < 10);
+    CHECK(filter.size() == 100);
+}
+
+TEST_CASE("Test Membership Filters Keep Find Correct") {
+    Tree<std::string, 4> tree;
+    Node<std::string> root_node("root");
+    tree.add_root(root_node);
+    std::vector<Node<std::string> *> nodes{tree.root.get()};
+    for (int i = 1; i < 100; ++i) {
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(i - 1) / 4], "id-" + std::to_string(i)));
+    }
+    CHECK_THROWS_AS(tree.track_membership(0), std::invalid_argument);
+    CHECK_THROWS_AS(tree.track_membership(2, 1.5), std::invalid_argument);
+
+    tree.track_membership(2, 0.01);
+    CHECK(tree.membership_memory() > 0);
+    CHECK(tree.find("id-77") == nodes[77]);
+    CHECK(tree.find("missing") == nullptr);
+
+    for (int i = 100; i < 400; ++i) {
+        nodes.push_back(tree.add_child(nodes[static_cast<size_t>(i - 1) / 4], "id-" + std::to_string(i)));
+    }
+    int misses = 0;
+    for (int i = 0; i < 400; i += 7) {
+        if (tree.find(nodes[static_cast<size_t>(i)]->data) != nodes[static_cast<size_t>(i)]) ++misses;
+    }
+    CHECK(misses == 0);
+
+    tree.set_data(nodes[300], "renamed");
+    CHECK(tree.find("renamed") == nodes[300]);
+    Node<std::string> parent("renamed");
+    Node<std::string> child("leaf");
+    tree.add_sub_node(parent, child);
+    CHECK(tree.find("leaf")->parent == nodes[300]);
+
+    tree.compact(Layout::BFS);
+    CHECK(tree.find("leaf") != nullptr);
+    CHECK(tree.find("id-250")->data == "id-250");
+}
+
+TEST_CASE("Test Membership Filters Respect Memory Budget") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> nodes{tree.root.get()};
+    for (int i = 1; i < 1000; ++i) nodes.push_back(tree.add_child(nodes[static_cast<size_t>(i - 1) / 3], i));
+
+    tree.track_membership(1, 0.001, 4096);
+    CHECK(tree.membership_memory() > 0);
+    CHECK(tree.membership_memory() <= 4096);
+
+    for (int i = 1000; i < 3000; ++i) nodes.push_back(tree.add_child(nodes[static_cast<size_t>(i - 1) / 3], i));
+    tree.set_data(nodes[5], -5);
+    CHECK(tree.membership_memory() <= 4096);
+
+    int mismatches = 0;
+    for (int i = 0; i < 3000; ++i) {
+        if (i != 5 && tree.find(i) != nodes[static_cast<size_t>(i)]) ++mismatches;
+    }
+    CHECK(mismatches == 0);
+    CHECK(tree.find(-5) == nodes[5]);
+
+    Tree<int, 3> tiny;
+    Node<int> tiny_root(0);
+    tiny.add_root(tiny_root);
+    tiny.add_child(tiny.root.get(), 1);
+    tiny.track_membership(1, 0.01, 8);
+    CHECK(tiny.membership_memory() == 0);
+    tiny.add_child(tiny.root.get(), 2);
+    CHECK(tiny.membership_memory() == 0);
+    CHECK(tiny.find(2) != nullptr);
+}
+
+TEST_CASE("Test Membership Filters Reset When Re-Rooting") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    std::vector<Node<int> *> nodes{tree.root.get()};
+    for (int i = 1; i < 1000; ++i) nodes.push_back(tree.add_child(nodes[static_cast<size_t>(i - 1) / 3], i));
+    tree.track_membership(1);
+
+    Tree<int, 3> fresh;
+    Node<int> new_root(-1);
+    fresh.add_root(new_root);
+    fresh.track_membership(1);
+
+    tree.add_root(new_root);
+    CHECK(tree.membership_memory() == fresh.membership_memory());
+    std::vector<Node<int> *> added{tree.root.get()};
+    for (int i = 1; i < 40; ++i) added.push_back(tree.add_child(added[static_cast<size_t>(i - 1) / 3], 1000 + i));
+    CHECK(tree.find(500) == nullptr);
+    int misses = 0;
+    for (int i = 1; i < 40; ++i) {
+        if (tree.find(1000 + i) != added[static_cast<size_t>(i)]) ++misses;
+    }
+    CHECK(misses == 0);
+}
+
+// Ordered Trees
+
+TEST_CASE("Test Ordered Tree Sorted Iteration and Lookup") {
+    OrderedTree<int, 4> tree;
+    CHECK(tree.height() == -1);
+    CHECK_FALSE(tree.begin_inorder().has_next());
+
+    std::vector<int> keys;
+    for (int i = 0; i < 500; ++i) keys.push_back((i * 37) % 500);
+    CHECK(std::all_of(keys.begin(), keys.end(), [&](int key) { return tree.insert(key); }));
+    CHECK_FALSE(tree.insert(42));
+    CHECK(tree.size() == 500);
+    CHECK(tree.height() <= 8);
+
+    std::vector<int> sorted = drain(tree.begin_inorder());
+    CHECK(sorted.size() == 500);
+    CHECK(std::is_sorted(sorted.begin(), sorted.end()));
+
+    CHECK(*tree.find(123) == 123);
+    CHECK(tree.find(999) == nullptr);
+    CHECK(tree.contains(0));
+}
+
+TEST_CASE("Test Ordered Tree Lower Bound and Range") {
+    OrderedTree<int, 3> tree;
+    for (int key = 0; key < 100; key += 5) tree.insert(key);
+
+    auto it = tree.lower_bound(42);
+    CHECK(it.next() == 45);
+    CHECK(it.next() == 50);
+    CHECK(tree.lower_bound(95).next() == 95);
+    CHECK_FALSE(tree.lower_bound(96).has_next());
+    CHECK(tree.range(12, 31) == std::vector<int>{15, 20, 25, 30});
+    CHECK(tree.range(200, 300).empty());
+}
+
+// K-ary Heaps
+
+TEST_CASE("Test K-ary Heap Push, Pop and Heapify") {
+    KaryHeap<int, 4> heap;
+    CHECK_THROWS_AS((void) heap.top(), std::out_of_range);
+    std::vector<int> values;
+    for (int i = 0; i < 300; ++i) values.push_back((i * 71) % 300);
+    for (int value : values) heap.push(value);
+
+    KaryHeap<int, 8> built(values);
+    std::vector<int> popped;
+    std::vector<int> popped_built;
+    while (!heap.empty()) {
+        popped.push_back(heap.top());
+        heap.pop();
+        popped_built.push_back(built.top());
+        built.pop();
+    }
+    CHECK(popped.size() == 300);
+    CHECK(std::is_sorted(popped.begin(), popped.end()));
+    CHECK(popped == popped_built);
+    CHECK_THROWS_AS(heap.pop(), std::out_of_range);
+}
+
+TEST_CASE("Test K-ary Heap Decrease Key via Handles") {
+    KaryHeap<int, 3> heap;
+    auto a = heap.push(50);
+    auto b = heap.push(20);
+    auto c = heap.push(70);
+    CHECK(heap.top_handle() == b);
+
+    heap.decrease_key(c, 10);
+    CHECK(heap.top() == 10);
+    CHECK(heap.top_handle() == c);
+    CHECK(heap.value(a) == 50);
+    CHECK_THROWS_AS(heap.decrease_key(a, 60), std::invalid_argument);
+
+    heap.pop();
+    CHECK_FALSE(heap.contains(c));
+    CHECK_THROWS_AS(heap.decrease_key(c, 1), std::invalid_argument);
+    auto d = heap.push(30);
+    CHECK(d == c);
+    heap.decrease_key(a, 5);
+    CHECK(heap.top_handle() == a);
+    CHECK(heap.size() == 3);
+}
+
+// Removal
+
+TEST_CASE("Test Remove Subtree Keeps Counts and Sibling Order") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    tree.track_subtree_sizes();
+    tree.track_value_bounds();
+    auto *a = tree.add_child(tree.root.get(), 1);
+    auto *b = tree.add_child(tree.root.get(), 2);
+    tree.add_child(tree.root.get(), 3);
+    tree.add_child(tree.add_child(b, 4), 9);
+    tree.add_child(a, 5);
+
+    tree.remove_subtree(b);
+    CHECK(drain(tree.begin_preorder()) == std::vector<int>{0, 1, 5, 3});
+    CHECK(tree.size() == 4);
+    CHECK(tree.height() == 2);
+    CHECK(tree.root->numOfChildren == 2);
+    CHECK(tree.root->subtree_size == 4);
+    CHECK(tree.root->bounds.max == 5);
+    CHECK(tree.find(4) == nullptr);
+
+    auto reused = reinterpret_cast<std::uintptr_t>(a->children.front().get());
+    tree.remove_subtree(a->children.front().get());
+    CHECK(tree.height() == 1);
+    CHECK(reinterpret_cast<std::uintptr_t>(tree.add_child(tree.root.get(), 6)) == reused);
+    CHECK(drain(tree.begin_preorder()) == std::vector<int>{0, 1, 3, 6});
+
+    Tree<int, 3> other;
+    other.add_root(root_node);
+    CHECK_THROWS_AS(tree.remove_subtree(other.root.get()), std::invalid_argument);
+    CHECK_THROWS_AS(tree.remove_subtree(nullptr), std::invalid_argument);
+
+    tree.remove_subtree(tree.root.get());
+    CHECK(tree.root == nullptr);
+    CHECK(tree.size() == 0);
+    CHECK(tree.height() == -1);
+}
+
+TEST_CASE("Test Remove Node Promotes or Rejects Children") {
+    Tree<int> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    tree.track_subtree_sizes();
+    auto *two = tree.add_child(tree.root.get(), 2);
+    auto *three = tree.add_child(tree.root.get(), 3);
+    tree.add_child(two, 4);
+    tree.add_child(tree.add_child(three, 5), 6);
+
+    CHECK_THROWS_AS(tree.remove_node(three, RemovePolicy::Reject), std::runtime_error);
+    tree.remove_node(two, RemovePolicy::Promote);
+    CHECK(drain(tree.begin_preorder()) == std::vector<int>{1, 4, 3, 5, 6});
+    CHECK(tree.root->left()->data == 4);
+    CHECK(tree.root->right() == three);
+    CHECK(tree.find(4)->depth == 1);
+    CHECK(tree.find(6)->depth == 3);
+    CHECK(tree.height() == 3);
+    CHECK(tree.root->subtree_size == 5);
+
+    tree.remove_node(tree.find(4), RemovePolicy::Reject);
+    CHECK(tree.root->numOfChildren == 1);
+    CHECK(tree.root->left() == three);
+    CHECK(tree.root->right() == nullptr);
+    tree.add_child(tree.root.get(), 8);
+    tree.add_child(three, 7);
+    CHECK_THROWS_AS(tree.remove_node(three, RemovePolicy::Promote), std::runtime_error);
+
+    tree.remove_subtree(tree.find(8));
+    tree.remove_subtree(tree.find(7));
+    tree.remove_node(tree.root.get(), RemovePolicy::Promote);
+    tree.remove_node(tree.root.get(), RemovePolicy::Promote);
+    CHECK(tree.root->data == 5);
+    CHECK(tree.root->parent == nullptr);
+    CHECK(tree.size() == 2);
+    CHECK(tree.height() == 1);
+    CHECK(drain(tree.begin_bfs()) == std::vector<int>{5, 6});
+}
+
+TEST_CASE("Test Remove Node Promotes Past Null Child Slots") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *two = tree.add_child(tree.root.get(), 2);
+    tree.add_child(tree.root.get(), 3);
+    tree.add_child(two, 4);
+    two->resize_children(3);
+
+    tree.remove_node(two, RemovePolicy::Promote);
+    CHECK(drain(tree.begin_preorder()) == std::vector<int>{1, 4, 3});
+    CHECK(tree.root->numOfChildren == 2);
+    CHECK(tree.root->children.size() == 2);
+
+    tree.remove_subtree(tree.find(3));
+    tree.root->resize_children(3);
+    tree.remove_node(tree.root.get(), RemovePolicy::Promote);
+    CHECK(tree.root->data == 4);
+    CHECK(tree.root->parent == nullptr);
+    CHECK(tree.size() == 1);
+}
+
+TEST_CASE("Test Destroying a Deep Tree Does Not Recurse") {
+    Tree<int, 1> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    Node<int> *tail = tree.root.get();
+    for (int i = 1; i < 200000; ++i) tail = tree.add_child(tail, i);
+    tree.remove_subtree(tree.root->children.front().get());
+    CHECK(tree.size() == 1);
+}
+
+TEST_CASE("Test Re-Rooting a Deep Tree Does Not Recurse") {
+    Tree<int, 1> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    Node<int> *tail = tree.root.get();
+    for (int i = 1; i < 300000; ++i) tail = tree.add_child(tail, i);
+
+    Node<int> new_root(-1);
+    tree.add_root(new_root);
+    CHECK(tree.size() == 1);
+    CHECK(tree.root->data == -1);
+    CHECK(tree.root->children.empty());
+}
+
+// Splice and Graft
+
+TEST_CASE("Test Splice Moves a Subtree Within a Tree") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    tree.track_subtree_sizes();
+    tree.track_value_bounds();
+    auto *a = tree.add_child(tree.root.get(), 1);
+    auto *b = tree.add_child(tree.root.get(), 2);
+    auto *c = tree.add_child(a, 3);
+    tree.add_child(tree.add_child(c, 4), 5);
+
+    tree.splice(c, b);
+    CHECK(drain(tree.begin_preorder()) == std::vector<int>{0, 1, 2, 3, 4, 5});
+    CHECK(c->parent == b);
+    CHECK(a->numOfChildren == 0);
+    CHECK(tree.find(5)->depth == 4);
+    CHECK(tree.height() == 4);
+    CHECK(a->subtree_size == 1);
+    CHECK(b->subtree_size == 4);
+    CHECK(a->bounds.max == 1);
+    CHECK(b->bounds.max == 5);
+
+    tree.splice(c, tree.root.get());
+    CHECK(tree.find(5)->depth == 3);
+    CHECK(tree.height() == 3);
+    CHECK(tree.root->numOfChildren == 3);
+    CHECK(drain(tree.begin_bfs()) == std::vector<int>{0, 1, 2, 3, 4, 5});
+
+    CHECK_THROWS_AS(tree.splice(c, tree.find(5)), std::invalid_argument);
+    CHECK_THROWS_AS(tree.splice(tree.root.get(), a), std::invalid_argument);
+    CHECK_THROWS_AS(tree.splice(a, tree.root.get()), std::runtime_error);
+
+    tree.find(4)->resize_children(3);
+    tree.splice(c, b);
+    CHECK(b->subtree_size == 4);
+    CHECK(tree.root->subtree_size == 6);
+}
+
+TEST_CASE("Test Graft Moves a Subtree Between Trees") {
+    Tree<int> source;
+    Node<int> source_root(10);
+    source.add_root(source_root);
+    auto *branch = source.add_child(source.root.get(), 11);
+    source.add_child(branch, 12);
+    source.add_child(source.root.get(), 13);
+
+    Tree<int> target;
+    Node<int> target_root(0);
+    target.add_root(target_root);
+    target.track_membership(1);
+    auto *leaf = target.add_child(target.root.get(), 1);
+
+    target.graft(source, branch, leaf);
+    CHECK(source.size() == 2);
+    CHECK(source.height() == 1);
+    CHECK(source.root->left()->data == 13);
+    CHECK(target.size() == 4);
+    CHECK(target.height() == 3);
+    CHECK(leaf->left() == branch);
+    CHECK(target.find(12) == branch->left());
+    CHECK(drain(target.begin_preorder()) == std::vector<int>{0, 1, 11, 12});
+
+    target.graft(source, source.root.get(), target.root.get());
+    CHECK(source.root == nullptr);
+    CHECK(source.size() == 0);
+    CHECK(target.size() == 6);
+    CHECK(target.find(13)->depth == 2);
+    CHECK_THROWS_AS(target.graft(source, target.find(13), leaf), std::invalid_argument);
+}
+
+// Bulk Construction
+
+TEST_CASE("Test Build From Parent Array in Any Order") {
+    std::vector<int> values{40, 10, 30, 0, 20, 50};
+    std::vector<std::ptrdiff_t> parents{2, 3, 3, -1, 1, 2};
+    using Ternary = Tree<int, 3>;
+    auto tree = Ternary::from_parent_array(values, parents);
+    CHECK(tree.size() == 6);
+    CHECK(tree.height() == 2);
+    CHECK(drain(tree.begin_preorder()) == std::vector<int>{0, 10, 20, 30, 40, 50});
+    CHECK(tree.find(50)->parent == tree.find(30));
+    CHECK(tree.find(20)->depth == 2);
+
+    auto expect_invalid = [&](std::vector<std::ptrdiff_t> bad) {
+        CHECK_THROWS_AS((void) Ternary::from_parent_array(values, bad), std::invalid_argument);
+    };
+    expect_invalid({2, 3, 3, -1, 1});
+    expect_invalid({2, 3, 3, -1, 1, -1});
+    expect_invalid({2, 3, 3, 0, 1, 2});
+    expect_invalid({2, 3, 3, -1, 9, 2});
+    expect_invalid({2, 3, 3, -1, 5, 4});
+    using Chain = Tree<int, 1>;
+    CHECK_THROWS_AS((void) Chain::from_parent_array(values, parents), std::invalid_argument);
+}
+
+TEST_CASE("Test Build From Edges Matches Incremental Build") {
+    std::vector<int> values(40);
+    std::vector<std::pair<size_t, size_t>> edges;
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i);
+        if (i > 0) edges.emplace_back(i, (i - 1) / 4);
+    }
+    std::shuffle(edges.begin(), edges.end(), std::mt19937(3));
+
+    using Quaternary = Tree<int, 4>;
+    auto built = Quaternary::from_edges(values, edges);
+    Tree<int, 4> incremental;
+    Node<int> root_node(0);
+    incremental.add_root(root_node);
+    for (int i = 1; i < 40; ++i) incremental.add_child(incremental.find((i - 1) / 4), i);
+    CHECK(drain(built.begin_preorder()) == drain(incremental.begin_preorder()));
+    CHECK(built.size() == incremental.size());
+    CHECK(built.height() == incremental.height());
+
+    edges.emplace_back(5, 2);
+    CHECK_THROWS_AS((void) Quaternary::from_edges(values, edges), std::invalid_argument);
+    edges.back() = {40, 2};
+    CHECK_THROWS_AS((void) Quaternary::from_edges(values, edges), std::invalid_argument);
+}
+
+TEST_CASE("Test Build From Edges Splits Large Inputs Across Threads") {
+    const size_t n = 1'100'000;
+    std::vector<int> values(n);
+    std::vector<std::pair<size_t, size_t>> edges;
+    edges.reserve(n - 1);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = static_cast<int>(i);
+        if (i > 0) edges.emplace_back(n - i, (n - i - 1) / 8);
+    }
+    using Octary = Tree<int, 8>;
+    auto tree = Octary::from_edges(values, edges, 4);
+    CHECK(tree.size() == n);
+    CHECK(tree.height() == 7);
+    CHECK(tree.root->numOfChildren == 8);
+
+    edges.back().first = edges.front().first;
+    CHECK_THROWS_AS((void) Octary::from_edges(values, edges, 4), std::invalid_argument);
+}
+
+TEST_CASE("Test Build Complete Tree From Level Order") {
+    std::vector<int> values(23);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i);
+
+    using Ternary = Tree<int, 3>;
+    auto tree = Ternary::from_level_order(values);
+    ImplicitTree<int, 3> implicit{std::span<const int>(values)};
+    CHECK(implicit.data().data() != values.data());
+    CHECK(tree.size() == 23);
+    CHECK(tree.height() == 3);
+    CHECK(drain(tree.begin_preorder()) == drain(implicit.begin_preorder()));
+    CHECK(drain(tree.begin_bfs()) == values);
+    CHECK(tree.find(7)->numOfChildren == 1);
+    CHECK(tree.find(8)->numOfChildren == 0);
+    CHECK(Ternary::from_level_order({}).root == nullptr);
+}
+
+// Flat Export
+
+TEST_CASE("Test Tree Exports Flat Level-Order Arrays") {
+    Tree<int, 3> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *a = tree.add_child(tree.root.get(), 2);
+    tree.add_child(tree.root.get(), 3);
+    tree.add_child(a, 4);
+    tree.add_child(a, 5);
+    tree.add_child(tree.find(3), 6);
+
+    auto flat = tree.to_flat();
+    CHECK_FALSE(flat.borrows_values());
+    CHECK(flat.size() == 6);
+    CHECK(std::vector<int>(flat.values().begin(), flat.values().end()) == drain(tree.begin_bfs()));
+    CHECK(std::vector<size_t>(flat.parents().begin(), flat.parents().end()) ==
+          std::vector<size_t>{FlatTree<int>::npos, 0, 0, 1, 1, 2});
+    CHECK(std::vector<size_t>(flat.offsets().begin(), flat.offsets().end()) ==
+          std::vector<size_t>{1, 3, 5, 6, 6, 6, 6});
+    CHECK(flat.num_children(1) == 2);
+    CHECK(Tree<int>().to_flat().empty());
+
+    tree.find(6)->resize_children(2);
+    auto padded = tree.to_flat();
+    CHECK(padded.size() == 6);
+    CHECK(std::vector<size_t>(padded.offsets().begin(), padded.offsets().end()) ==
+          std::vector<size_t>{1, 3, 5, 6, 6, 6, 6});
+}
+
+TEST_CASE("Test Implicit Tree Flat Export Borrows Values") {
+    ImplicitTree<int, 2> tree({1, 2, 3, 4, 5, 6});
+    auto flat = tree.to_flat();
+    CHECK(flat.borrows_values());
+    CHECK(flat.values().data() == tree.data().data());
+    CHECK(std::vector<size_t>(flat.parents().begin(), flat.parents().end()) ==
+          std::vector<size_t>{FlatTree<int>::npos, 0, 0, 1, 1, 2});
+    CHECK(std::vector<size_t>(flat.offsets().begin(), flat.offsets().end()) ==
+          std::vector<size_t>{1, 3, 5, 6, 6, 6, 6});
+
+    auto rebuilt = Tree<int>::from_level_order(flat.values());
+    CHECK(drain(rebuilt.begin_bfs()) == std::vector<int>{1, 2, 3, 4, 5, 6});
+}
+
+// Frozen Snapshots
+
+TEST_CASE("Test Frozen Tree Traversals Match the Source") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    for (int i = 1; i < 30; ++i) tree.add_child(tree.find(i / 3), i);
+
+    auto frozen = tree.freeze();
+    CHECK(frozen.size() == tree.size());
+    CHECK(frozen.height() == tree.height());
+    CHECK(drain(frozen.begin_preorder()) == drain(tree.begin_preorder()));
+    CHECK(drain(frozen.begin_postorder()) == drain(tree.begin_postorder()));
+    CHECK(drain(frozen.begin_inorder()) == drain(tree.begin_inorder()));
+    CHECK(drain(frozen.begin_bfs()) == drain(tree.begin_bfs()));
+
+    tree.add_child(tree.find(29), 30);
+    CHECK(frozen.size() == 30);
+    CHECK(frozen.find(30) == FrozenTree<int, 3>::npos);
+    CHECK(Tree<int>().freeze().height() == -1);
+}
+
+TEST_CASE("Test Frozen Tree Subtree Ranges and Structure") {
+    Tree<int> tree;
+    Node<int> root_node(1);
+    tree.add_root(root_node);
+    auto *two = tree.add_child(tree.root.get(), 2);
+    tree.add_child(tree.root.get(), 3);
+    tree.add_child(two, 4);
+    tree.add_child(two, 5);
+
+    auto frozen = tree.freeze();
+    size_t id = frozen.find(2);
+    CHECK(id == 1);
+    CHECK(frozen.subtree_size(id) == 3);
+    CHECK(std::vector<int>(frozen.subtree_values(id).begin(), frozen.subtree_values(id).end()) ==
+          std::vector<int>{2, 4, 5});
+    CHECK(frozen.children(id).size() == 2);
+    CHECK(frozen.value(frozen.children(id)[1]) == 5);
+    CHECK(frozen.parent(frozen.find(5)) == id);
+    CHECK(frozen.depth(frozen.find(5)) == 2);
+    CHECK(frozen.is_ancestor(id, frozen.find(4)));
+    CHECK_FALSE(frozen.is_ancestor(id, frozen.find(3)));
+    CHECK(frozen.parent(0) == FrozenTree<int>::npos);
+
+    std::vector<long> sums(4, 0);
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < sums.size(); ++t) {
+        readers.emplace_back([&, t] {
+            for (auto it = frozen.begin_postorder(); it.has_next();) sums[t] += it.next();
+        });
+    }
+    for (auto &reader : readers) reader.join();
+    CHECK(std::count(sums.begin(), sums.end(), 15) == 4);
+}
+
+// Deep Copies
+
+TEST_CASE("Test Copy Clones Structure and Augmentations") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    tree.track_subtree_sizes();
+    tree.track_value_bounds();
+    tree.track_membership(1);
+    for (int i = 1; i < 40; ++i) tree.add_child(tree.find((i - 1) / 3), i);
+
+    Tree<int, 3> copy(tree);
+    CHECK(copy.size() == tree.size());
+    CHECK(copy.height() == tree.height());
+    CHECK(drain(copy.begin_preorder()) == drain(tree.begin_preorder()));
+    CHECK(drain(copy.begin_inorder()) == drain(tree.begin_inorder()));
+    CHECK(copy.root->subtree_size == 40);
+    CHECK(copy.root->bounds.max == 39);
+    CHECK(copy.membership_memory() == tree.membership_memory());
+
+    auto *copied = copy.find(13);
+    REQUIRE(copied != nullptr);
+    CHECK(copied != tree.find(13));
+    CHECK(copied->parent == copy.find(4));
+    CHECK(copied->depth == 3);
+
+    copy.add_child(copied, 100);
+    CHECK(tree.find(100) == nullptr);
+    CHECK(copy.root->bounds.max == 100);
+    CHECK(tree.root->bounds.max == 39);
+
+    Tree<int, 3> assigned;
+    assigned = copy;
+    copy.remove_subtree(copy.find(1));
+    CHECK(assigned.size() == 41);
+    CHECK(assigned.find(100)->parent == assigned.find(13));
+}
+
+TEST_CASE("Test Copy of a Padded Tree Keeps Membership Filters") {
+    Tree<int, 3> tree;
+    Node<int> root_node(0);
+    tree.add_root(root_node);
+    auto *one = tree.add_child(tree.root.get(), 1);
+    tree.add_child(tree.root.get(), 2);
+    one->resize_children(2);
+    auto *three = tree.add_child(one, 3);
+    tree.add_child(three, 4);
+    tree.add_child(three, 5);
+    tree.track_membership(1);
+
+    Tree<int, 3> copy(tree);
+    CHECK(copy.membership_memory() == tree.membership_memory());
+    CHECK(copy.find(5) != nullptr);
+    CHECK(copy.find(5) != tree.find(5));
+    CHECK(copy.find(5)->parent == copy.find(3));
+    CHECK(copy.find(6) == nullptr);
+}
+
+TEST_CASE("Test Copy of Large and Deep Trees") {
+    std::vector<int> values(200000);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i);
+    auto wide = Tree<int, 4>::from_level_order(values);
+    Tree<int, 4> wide_copy(wide);
+    CHECK(wide_copy.size() == wide.size());
+    CHECK(drain(wide_copy.begin_bfs()) == values);
+    auto threaded = wide.clone(4);
+    CHECK(threaded.height() == wide.height());
+    CHECK(drain(threaded.begin_bfs()) == values);
+    CHECK(threaded.find(199999)->parent == threaded.find(49999));
+
+    Tree<int, 1> chain;
+    Node<int> root_node(0);
+    chain.add_root(root_node);
+    Node<int> *tail = chain.root.get();
+    for (int i = 1; i < 100000; ++i) tail = chain.add_child(tail, i);
+    Tree<int, 1> chain_copy(chain);
+    CHECK(chain_copy.height() == 99999);
+    const Node<int> *copy_tail = chain_copy.root.get();
+    while (copy_tail->numOfChildren > 0) copy_tail = copy_tail->children.front().get();
+    CHECK(copy_tail->data == 99999);
+    CHECK(copy_tail->depth == 99999);
+
+    Tree<int, 1> taken(std::move(chain_copy));
+    CHECK(chain_copy.size() == 0);
+    CHECK(chain_copy.height() == -1);
+    CHECK(taken.size() == 100000);
+    chain_copy.add_root(root_node);
+    CHECK(chain_copy.size() == 1);
+}
+
+// Copy-on-Write
+
+TEST_CASE("Test Copy-on-Write Copies Share Unchanged Subtrees") {
+    std::vector<int> values(40);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i);
+    using Ternary = Tree<int, 3>;
+    auto source = Ternary::from_level_order(values);
+    CowTree<int, 3> baseline(source);
+    CHECK(baseline.size() == 40);
+    CHECK(drain(baseline.begin_preorder()) == drain(source.begin_preorder()));
+    CHECK(drain(baseline.begin_postorder()) == drain(source.begin_postorder()));
+    CHECK(drain(baseline.begin_inorder()) == drain(source.begin_inorder()));
+    CHECK(drain(baseline.begin_bfs()) == values);
+
+    auto copy = baseline;
+    CHECK(copy.shares_subtree(baseline, {}));
+    copy.set_data({1, 2}, -1);
+    CHECK(copy.get({1, 2}) == -1);
+    CHECK(baseline.get({1, 2}) == 9);
+    CHECK_FALSE(copy.shares_subtree(baseline, {}));
+    CHECK_FALSE(copy.shares_subtree(baseline, {1}));
+    CHECK(copy.shares_subtree(baseline, {0}));
+    CHECK(copy.shares_subtree(baseline, {1, 0}));
+    CHECK(copy.shares_subtree(baseline, {1, 2, 0}));
+
+    auto child = copy.add_child({1, 2, 0}, 100);
+    CHECK(child == CowTree<int, 3>::Path{1, 2, 0, 0});
+    CHECK(copy.size() == 41);
+    CHECK(baseline.size() == 40);
+    CHECK(baseline.num_children({1, 2, 0}) == 0);
+    CHECK(copy.shares_subtree(baseline, {2}));
+    CHECK_THROWS_AS((void) copy.get({3}), std::out_of_range);
+    CHECK_THROWS_AS(copy.add_child({}, 5), std::runtime_error);
+}
+
+TEST_CASE("Test Copy-on-Write Mutates Unshared Nodes in Place") {
+    CowTree<int> tree;
+    tree.add_root(1);
+    tree.add_child({}, 2);
+    tree.add_child({0}, 3);
+
+    auto before = tree;
+    tree.set_data({0, 0}, 30);
+    CHECK(before.get({0, 0}) == 3);
+
+    auto iterator = tree.begin_preorder();
+    before = CowTree<int>();
+    tree.set_data({0}, 20);
+    CHECK(drain(iterator) == std::vector<int>{1, 2, 30});
+    CHECK(drain(tree.begin_preorder()) == std::vector<int>{1, 20, 30});
+    CHECK_THROWS_AS(tree.add_root(0), std::logic_error);
+
+    Tree<int, 3> padded;
+    Node<int> root_node(1);
+    padded.add_root(root_node);
+    padded.root->resize_children(2);
+    padded.add_child(padded.root.get(), 2);
+    CowTree<int, 3> skipped(padded);
+    CHECK(skipped.size() == 2);
+    CHECK(skipped.num_children({}) == 1);
+    CHECK(skipped.get({0}) == 2);
+}
+
+TEST_CASE("Test Copy-on-Write Releases Deep Chains Without Recursion") {
+    Tree<int, 1> chain;
+    Node<int> root_node(0);
+    chain.add_root(root_node);
+    Node<int> *tail = chain.root.get();
+    for (int i = 1; i < 300000; ++i) tail = chain.add_child(tail, i);
+
+    const CowTree<int, 1>::Path deepest(299999, 0);
+    CowTree<int, 1> original(chain);
+    auto edited = original;
+    edited.set_data(deepest, -1);
+    auto shared = edited;
+
+    original = CowTree<int, 1>();
+    edited = CowTree<int, 1>();
+    CHECK(shared.size() == 300000);
+    CHECK(shared.get(deepest) == -1);
+    CHECK(shared.get(CowTree<int, 1>::Path(150000, 0)) == 150000);
+}
+
+// Persistent Versions
+
+TEST_CASE("Test Persistent Tree Keeps Every Version Queryable") {
+    PersistentTree<int, 3> empty_version;
+    auto v1 = PersistentTree<int, 3>(1).add_child({}, 2).add_child({}, 3).add_child({0}, 4);
+    auto v2 = v1.set_data({0, 0}, 40);
+    auto v3 = v2.add_child({1}, 5);
+
+    CHECK(empty_version.empty());
+    CHECK(drain(v1.begin_preorder()) == std::vector<int>{1, 2, 4, 3});
+    CHECK(drain(v2.begin_preorder()) == std::vector<int>{1, 2, 40, 3});
+    CHECK(drain(v3.begin_bfs()) == std::vector<int>{1, 2, 3, 40, 5});
+    CHECK(drain(v3.begin_postorder()) == std::vector<int>{40, 2, 5, 3, 1});
+    CHECK(v1.size() == 4);
+    CHECK(v3.size() == 5);
+    CHECK(v1.get({0, 0}) == 4);
+
+    CHECK(v2.shares_subtree(v1, {1}));
+    CHECK_FALSE(v2.shares_subtree(v1, {0}));
+    CHECK(v3.shares_subtree(v2, {0}));
+    CHECK_FALSE(v3.shares_subtree(v2, {1}));
+    CHECK_THROWS_AS((void) v1.set_data({2}, 0), std::out_of_range);
+}
+
+struct Counted {
+    static inline int live = 0;
+    int value;
+
+    explicit Counted(int value) : value(value) { ++live; }
+    Counted(const Counted &other) : value(other.value) { ++live; }
+    Counted &operator=(const Counted &) = default;
+    ~Counted() { --live; }
+};
+
+TEST_CASE("Test Persistent Tree Frees Unreachable Versions") {
+    {
+        PersistentTree<Counted> base(Counted(0));
+        base = base.add_child({}, Counted(1)).add_child({0}, Counted(2));
+        CHECK(Counted::live == 3);
+
+        auto edited = base.set_data({0, 0}, Counted(20));
+        CHECK(Counted::live == 6);
+        CHECK(edited.get({0, 0}).value == 20);
+
+        for (int i = 0; i < 10; ++i) edited = edited.set_data({0, 0}, Counted(i));
+        CHECK(Counted::live == 6);
+        CHECK(base.get({0, 0}).value == 2);
+    }
+    CHECK(Counted::live == 0);
+}
+
+TEST_CASE("Test Persistent Tree Destroys Deep Versions") {
+    Tree<int, 1> chain;
+    Node<int> root_node(0);
+    chain.add_root(root_node);
+    Node<int> *tail = chain.root.get();
+    for (int i = 1; i < 300000; ++i) tail = chain.add_child(tail, i);
+
+    const PersistentTree<int, 1>::Path deepest(299999, 0);
+    {
+        PersistentTree<int, 1> base(chain);
+        auto edited = base.set_data(deepest, -1);
+        auto grown = edited.add_child(deepest, 300000);
+        CHECK(base.get(deepest) == 299999);
+        CHECK(edited.get(deepest) == -1);
+        CHECK(grown.size() == 300001);
+    }
+    CHECK(PersistentTree<int, 1>(chain).size() == 300000);
+}
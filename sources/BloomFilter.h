@@ -0,0 +1,104 @@
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief A Bloom filter: a compact set that may report false positives but never false negatives.
+ *
+ * Probe positions come from double hashing of std::hash, so a value is hashed only
+ * once no matter how many filters it is checked against.
+ *
+ * @tparam T The type of the values stored; must be hashable with std::hash.
+ */
+template<typename T>
+class BloomFilter {
+public:
+    /**
+     * @brief The two base hashes every probe position is derived from.
+     */
+    struct Hash {
+        uint64_t first;
+        uint64_t second;
+    };
+
+    /**
+     * @brief Constructs an empty filter sized for @p capacity values.
+     *
+     * @param capacity The number of values the filter is sized for.
+     * @param bits_per_item Bits of storage per value; more bits mean fewer false positives.
+     */
+    BloomFilter(size_t capacity, double bits_per_item) : expected(capacity) {
+        bits.assign(words_for(capacity, bits_per_item), 0);
+        probes = std::max<size_t>(1, static_cast<size_t>(std::lround(bits_per_item * std::log(2.0))));
+    }
+
+    /**
+     * @brief Returns the bytes a filter constructed with these arguments holds, without building it.
+     */
+    static size_t memory_bytes_for(size_t capacity, double bits_per_item) {
+        return words_for(capacity, bits_per_item) * sizeof(uint64_t);
+    }
+
+    /**
+     * @brief Returns the bits per value needed for a target false-positive rate.
+     */
+    static double bits_per_item_for(double false_positive_rate) {
+        return -std::log(false_positive_rate) / (std::log(2.0) * std::log(2.0));
+    }
+
+    static Hash hash(const T &value) {
+        auto base = static_cast<uint64_t>(std::hash<T>{}(value));
+        // Mix the bits so the second hash is independent even for identity hashes like std::hash<int>.
+        uint64_t mixed = (base ^ (base >> 31)) * 0x9E3779B97F4A7C15ULL;
+        mixed ^= mixed >> 29;
+        return {base, mixed | 1};
+    }
+
+    void insert(const Hash &h) {
+        for (size_t i = 0; i < probes; ++i) {
+            uint64_t bit = position(h, i);
+            bits[bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+        ++items;
+    }
+
+    void insert(const T &value) { insert(hash(value)); }
+
+    [[nodiscard]] bool might_contain(const Hash &h) const {
+        for (size_t i = 0; i < probes; ++i) {
+            uint64_t bit = position(h, i);
+            if (!(bits[bit / 64] & (uint64_t{1} << (bit % 64)))) return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool might_contain(const T &value) const { return might_contain(hash(value)); }
+
+    [[nodiscard]] size_t size() const { return items; }
+
+    [[nodiscard]] size_t capacity() const { return expected; }
+
+    [[nodiscard]] size_t memory_bytes() const { return bits.size() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> bits;
+    size_t probes;
+    size_t items = 0;
+    size_t expected;
+
+    static size_t words_for(size_t capacity, double bits_per_item) {
+        auto bit_count = static_cast<size_t>(std::ceil(static_cast<double>(capacity) * bits_per_item));
+        return bit_count / 64 + 1;
+    }
+
+    [[nodiscard]] uint64_t position(const Hash &h, size_t i) const {
+        return (h.first + i * h.second) % (bits.size() * 64);
+    }
+};
+
+#endif // BLOOM_FILTER_HPP
@@ -0,0 +1,346 @@
+#ifndef COW_TREE_HPP
+#define COW_TREE_HPP
+
+#include "Tree.h"
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A k-ary tree whose copies share all unchanged subtrees (copy-on-write).
+ *
+ * Copying is O(1): the copy points at the same root. A mutation copies only the
+ * nodes on the path from the root to the touched node that are still shared
+ * with another copy; nodes owned by this copy alone are changed in place. Each
+ * copy therefore costs memory proportional to the nodes it changed, times the
+ * depth at which they sit.
+ *
+ * Nodes carry no parent pointers, since a shared node may have a different
+ * parent in every copy, so nodes are addressed by their path: the child index
+ * taken at every level, starting below the root. Copies may be read from several
+ * threads, but a copy must not be mutated while another thread copies or reads it.
+ *
+ * @tparam T The type of the data stored in the tree nodes.
+ * @tparam N The maximum number of children each node can have. Default is 2.
+ */
+template<typename T, int N = 2>
+class CowTree {
+    struct CowNode {
+        T data;
+        std::vector<std::shared_ptr<CowNode>> children;
+
+        explicit CowNode(T value) : data(std::move(value)) {}
+    };
+
+public:
+    using Path = std::vector<size_t>;
+
+    /**
+     * @brief Default constructor.
+     * Initializes an empty tree.
+     */
+    CowTree() = default;
+
+    /**
+     * @brief Builds a tree with the same shape and values as @p tree, without recursion.
+     *
+     * Null child slots are skipped, so paths index the real children only.
+     */
+    explicit CowTree(const Tree<T, N> &tree) {
+        if (!tree.root) return;
+
+        root = std::make_shared<CowNode>(tree.root->data);
+        std::vector<std::pair<const Node<T> *, CowNode *>> pending{{tree.root.get(), root.get()}};
+        while (!pending.empty()) {
+            auto [source, copy] = pending.back();
+            pending.pop_back();
+            ++count;
+            copy->children.reserve(source->children.size());
+            for (const auto &child : source->children) {
+                if (!child) continue;
+                copy->children.push_back(std::make_shared<CowNode>(child->data));
+                pending.emplace_back(child.get(), copy->children.back().get());
+            }
+        }
+    }
+
+    /**
+     * @brief Copy constructor; shares every node with @p other in O(1).
+     */
+    CowTree(const CowTree &other) = default;
+
+    /**
+     * @brief Move constructor; takes over the nodes of @p other and leaves it empty.
+     */
+    CowTree(CowTree &&other) noexcept : root(std::move(other.root)), count(std::exchange(other.count, 0)) {}
+
+    CowTree &operator=(const CowTree &other) {
+        if (this != &other) *this = CowTree(other);
+        return *this;
+    }
+
+    CowTree &operator=(CowTree &&other) noexcept {
+        if (this == &other) return *this;
+        release(std::move(root));
+        root = std::move(other.root);
+        count = std::exchange(other.count, 0);
+        return *this;
+    }
+
+    /**
+     * @brief Destructor.
+     * Frees the nodes no other copy shares, without recursion.
+     */
+    ~CowTree() {
+        release(std::move(root));
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return !root; }
+
+    /**
+     * @brief Returns the value of the node at @p path.
+     *
+     * @throws std::out_of_range If no node sits at the path.
+     */
+    const T &get(const Path &path) const {
+        return at(path)->data;
+    }
+
+    /**
+     * @brief Returns the number of children of the node at @p path.
+     *
+     * @throws std::out_of_range If no node sits at the path.
+     */
+    [[nodiscard]] size_t num_children(const Path &path) const {
+        return at(path)->children.size();
+    }
+
+    /**
+     * @brief Returns whether this tree and @p other share the subtree at @p path.
+     *
+     * @throws std::out_of_range If either tree has no node at the path.
+     */
+    [[nodiscard]] bool shares_subtree(const CowTree &other, const Path &path) const {
+        return at(path) == other.at(path);
+    }
+
+    /**
+     * @brief Sets the root of an empty tree.
+     *
+     * @throws std::logic_error If the tree already has a root.
+     */
+    void add_root(const T &value) {
+        if (root) throw std::logic_error("Tree already has a root.");
+        root = std::make_shared<CowNode>(value);
+        count = 1;
+    }
+
+    /**
+     * @brief Changes the value of the node at @p path in O(depth * N).
+     *
+     * @throws std::out_of_range If no node sits at the path.
+     */
+    void set_data(const Path &path, const T &value) {
+        own_path(path)->data = value;
+    }
+
+    /**
+     * @brief Appends a child to the node at @p path in O(depth * N).
+     *
+     * @return Path The path of the new child.
+     *
+     * @throws std::out_of_range If no node sits at the path.
+     * @throws std::runtime_error If the node has reached the maximum number of children.
+     */
+    Path add_child(const Path &path, const T &value) {
+        if (at(path)->children.size() == static_cast<size_t>(N)) {
+            throw std::runtime_error("Parent node has reached maximum number of children.");
+        }
+        CowNode *parent = own_path(path);
+        parent->children.push_back(std::make_shared<CowNode>(value));
+        ++count;
+
+        Path child = path;
+        child.push_back(parent->children.size() - 1);
+        return child;
+    }
+
+    /**
+     * @brief Pre-order iterator over one version of the tree.
+     */
+    class PreOrderIterator {
+    public:
+        explicit PreOrderIterator(std::shared_ptr<const CowNode> root) {
+            if (root) stack.push_back(std::move(root));
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !stack.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            auto node = std::move(stack.back());
+            stack.pop_back();
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) stack.push_back(*it);
+            return node->data;
+        }
+
+    private:
+        std::vector<std::shared_ptr<const CowNode>> stack;
+    };
+
+    /**
+     * @brief Post-order iterator over one version of the tree.
+     */
+    class PostOrderIterator {
+    public:
+        explicit PostOrderIterator(std::shared_ptr<const CowNode> root) {
+            if (root) stack.emplace_back(std::move(root), false);
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !stack.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            while (!stack.back().second) {
+                stack.back().second = true;
+                auto node = stack.back().first;
+                for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) stack.emplace_back(*it, false);
+            }
+            auto node = std::move(stack.back().first);
+            stack.pop_back();
+            return node->data;
+        }
+
+    private:
+        std::vector<std::pair<std::shared_ptr<const CowNode>, bool>> stack; ///< Nodes and whether their children were pushed.
+    };
+
+    /**
+     * @brief In-order iterator: first child's subtree, the node, then the remaining subtrees.
+     */
+    class InOrderIterator {
+    public:
+        explicit InOrderIterator(std::shared_ptr<const CowNode> root) {
+            if (root) stack.emplace_back(std::move(root), false);
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !stack.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            while (!stack.back().second) {
+                auto node = std::move(stack.back().first);
+                stack.pop_back();
+                for (size_t k = node->children.size(); k-- > 1;) stack.emplace_back(node->children[k], false);
+                stack.emplace_back(node, true);
+                if (!node->children.empty()) stack.emplace_back(node->children.front(), false);
+            }
+            auto node = std::move(stack.back().first);
+            stack.pop_back();
+            return node->data;
+        }
+
+    private:
+        std::vector<std::pair<std::shared_ptr<const CowNode>, bool>> stack; ///< Nodes and whether they are due next.
+    };
+
+    /**
+     * @brief Breadth-first iterator over one version of the tree.
+     */
+    class BFSIterator {
+    public:
+        explicit BFSIterator(std::shared_ptr<const CowNode> root) {
+            if (root) queue.push(std::move(root));
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !queue.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            auto node = std::move(queue.front());
+            queue.pop();
+            for (const auto &child : node->children) queue.push(child);
+            return node->data;
+        }
+
+    private:
+        std::queue<std::shared_ptr<const CowNode>> queue;
+    };
+
+    using DFSIterator = PreOrderIterator;
+
+    PreOrderIterator begin_preorder() const { return PreOrderIterator(root); }
+    PostOrderIterator begin_postorder() const { return PostOrderIterator(root); }
+    InOrderIterator begin_inorder() const { return InOrderIterator(root); }
+    BFSIterator begin_bfs() const { return BFSIterator(root); }
+    DFSIterator begin_dfs() const { return DFSIterator(root); }
+
+private:
+    std::shared_ptr<CowNode> root;
+    size_t count = 0;
+
+    const CowNode *at(const Path &path) const {
+        const CowNode *node = root.get();
+        if (!node) throw std::out_of_range("No node at this path");
+        for (size_t index : path) {
+            if (index >= node->children.size()) throw std::out_of_range("No node at this path");
+            node = node->children[index].get();
+        }
+        return node;
+    }
+
+    /**
+     * @brief Drops one reference to @p node and frees what only it kept alive.
+     *
+     * Descends only into nodes this reference owns alone, so subtrees shared with
+     * another copy are left untouched and deep chains do not recurse.
+     */
+    static void release(std::shared_ptr<CowNode> node) {
+        std::vector<std::shared_ptr<CowNode>> pending;
+        if (node) pending.push_back(std::move(node));
+        while (!pending.empty()) {
+            auto current = std::move(pending.back());
+            pending.pop_back();
+            if (current.use_count() != 1) continue;
+            for (auto &child : current->children) pending.push_back(std::move(child));
+            current->children.clear();
+        }
+    }
+
+    /**
+     * @brief Makes every node from the root down to @p path owned by this tree alone.
+     *
+     * A node is copied when another tree still references it. Copying a node
+     * shares its children once more, so everything below the first copy on the
+     * path is copied as well, while an unshared prefix is reused in place.
+     *
+     * @return CowNode* The node at the path, safe to modify.
+     */
+    CowNode *own_path(const Path &path) {
+        (void) at(path);
+        std::shared_ptr<CowNode> *slot = &root;
+        for (size_t step = 0;; ++step) {
+            if (slot->use_count() > 1) *slot = std::make_shared<CowNode>(**slot);
+            if (step == path.size()) return slot->get();
+            slot = &(*slot)->children[path[step]];
+        }
+    }
+};
+
+#endif // COW_TREE_HPP
@@ -0,0 +1,75 @@
+#ifndef FENWICK_TREE_HPP
+#define FENWICK_TREE_HPP
+
+#include <bit>
+#include <vector>
+
+/**
+ * @brief Binary indexed tree over a fixed-size array of summable values.
+ *
+ * Point updates, prefix sums and prefix searches all run in O(log n).
+ *
+ * @tparam T A type supporting +, -, < and value-initialization to zero.
+ */
+template<typename T>
+class FenwickTree {
+public:
+    FenwickTree() = default;
+
+    /**
+     * @brief Builds the tree over the given values in O(n).
+     *
+     * @param values The values, by position.
+     */
+    explicit FenwickTree(const std::vector<T> &values) : sums(values.size() + 1, T{}) {
+        for (size_t i = 1; i < sums.size(); ++i) {
+            sums[i] = sums[i] + values[i - 1];
+            size_t up = i + (i & (~i + 1));
+            if (up < sums.size()) sums[up] = sums[up] + sums[i];
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return sums.empty() ? 0 : sums.size() - 1; }
+
+    /**
+     * @brief Adds @p delta to the value at one position.
+     */
+    void add(size_t position, const T &delta) {
+        for (size_t i = position + 1; i < sums.size(); i += i & (~i + 1)) {
+            sums[i] = sums[i] + delta;
+        }
+    }
+
+    /**
+     * @brief Returns the sum of the first @p count values.
+     */
+    T prefix(size_t count) const {
+        T sum{};
+        for (size_t i = count; i > 0; i -= i & (~i + 1)) sum = sum + sums[i];
+        return sum;
+    }
+
+    T total() const { return prefix(size()); }
+
+    /**
+     * @brief Returns the first position whose prefix sum, itself included, exceeds @p target.
+     *
+     * Assumes all values are non-negative. Returns size() if no prefix exceeds the target.
+     */
+    size_t upper_bound(T target) const {
+        size_t position = 0;
+        for (size_t step = std::bit_floor(size()); step > 0; step /= 2) {
+            size_t next = position + step;
+            if (next < sums.size() && !(target < sums[next])) {
+                position = next;
+                target = target - sums[next];
+            }
+        }
+        return position;
+    }
+
+private:
+    std::vector<T> sums; ///< sums[i] covers the values in (i - lowbit(i), i], one-based.
+};
+
+#endif // FENWICK_TREE_HPP
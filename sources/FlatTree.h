@@ -0,0 +1,81 @@
+#ifndef FLAT_TREE_HPP
+#define FLAT_TREE_HPP
+
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A tree exported as flat arrays in level order, for consumers that do not want node pointers.
+ *
+ * Node 0 is the root and nodes are numbered level by level, so the children of
+ * node i are the consecutive nodes offsets()[i] ... offsets()[i + 1] - 1. The
+ * layout is the CSR form of the child lists with the child index array left out.
+ *
+ * Values are either owned by the flat tree or borrowed from a source that already
+ * keeps them contiguously in level order; borrowed values stay valid only as long
+ * as that source is alive and unchanged.
+ *
+ * @tparam T The type of the node values.
+ */
+template<typename T>
+class FlatTree {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    FlatTree() = default;
+
+    /**
+     * @brief Takes ownership of values and structure arrays.
+     *
+     * @param values The value of every node, in level order.
+     * @param parents The parent of every node, npos for the root.
+     * @param offsets size() + 1 child offsets as described above.
+     */
+    FlatTree(std::vector<T> values, std::vector<size_t> parents, std::vector<size_t> offsets)
+            : owned(std::move(values)), parent_index(std::move(parents)), child_offsets(std::move(offsets)) {}
+
+    /**
+     * @brief Borrows the values and owns only the structure arrays.
+     */
+    FlatTree(std::span<const T> values, std::vector<size_t> parents, std::vector<size_t> offsets)
+            : borrowed(values), parent_index(std::move(parents)), child_offsets(std::move(offsets)) {}
+
+    [[nodiscard]] size_t size() const { return parent_index.size(); }
+
+    [[nodiscard]] bool empty() const { return parent_index.empty(); }
+
+    /**
+     * @brief Returns the node values in level order.
+     */
+    [[nodiscard]] std::span<const T> values() const {
+        return borrowed.data() ? borrowed : std::span<const T>(owned);
+    }
+
+    /**
+     * @brief Returns the parent index of every node, npos for the root.
+     */
+    [[nodiscard]] std::span<const size_t> parents() const { return parent_index; }
+
+    /**
+     * @brief Returns the size() + 1 child offsets; node i's children are [offsets[i], offsets[i + 1]).
+     */
+    [[nodiscard]] std::span<const size_t> offsets() const { return child_offsets; }
+
+    [[nodiscard]] size_t num_children(size_t index) const {
+        return child_offsets[index + 1] - child_offsets[index];
+    }
+
+    /**
+     * @brief Returns whether the values are a view into the source rather than a copy.
+     */
+    [[nodiscard]] bool borrows_values() const { return borrowed.data() != nullptr; }
+
+private:
+    std::vector<T> owned;
+    std::span<const T> borrowed;
+    std::vector<size_t> parent_index;
+    std::vector<size_t> child_offsets;
+};
+
+#endif // FLAT_TREE_HPP
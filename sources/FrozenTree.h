@@ -0,0 +1,220 @@
+#ifndef FROZEN_TREE_HPP
+#define FROZEN_TREE_HPP
+
+#include "Node.h"
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief An immutable snapshot of a Tree in flat, pre-order numbered arrays.
+ *
+ * Node ids are pre-order positions, so the subtree of node i is the id range
+ * [i, subtree_end(i)) and its values form one contiguous span. Children are
+ * stored back to back in CSR form, and the post-order, in-order and level-order
+ * sequences are precomputed, so every traversal is a linear scan.
+ *
+ * A frozen tree holds no shared pointers and is never modified after
+ * construction, so any number of threads may read it without synchronization.
+ *
+ * @tparam T The type of the data stored in the tree nodes.
+ * @tparam N The maximum number of children of the tree it was frozen from.
+ */
+template<typename T, int N = 2>
+class FrozenTree {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Default constructor.
+     * Initializes an empty snapshot.
+     */
+    FrozenTree() = default;
+
+    /**
+     * @brief Snapshots the tree below @p root in O(n).
+     *
+     * @param root The root of the tree to freeze, or nullptr for an empty snapshot.
+     */
+    explicit FrozenTree(const Node<T> *root) {
+        if (!root) return;
+
+        std::vector<std::pair<const Node<T> *, size_t>> pending{{root, npos}};
+        while (!pending.empty()) {
+            auto [node, parent] = pending.back();
+            pending.pop_back();
+            const size_t id = data.size();
+            data.push_back(node->data);
+            parents.push_back(parent);
+            depths.push_back(parent == npos ? 0 : depths[parent] + 1);
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) pending.emplace_back(it->get(), id);
+            }
+        }
+
+        const size_t n = data.size();
+        std::vector<size_t> sizes(n, 1);
+        for (size_t i = n; i-- > 1;) sizes[parents[i]] += sizes[i];
+        ends.resize(n);
+        for (size_t i = 0; i < n; ++i) ends[i] = i + sizes[i];
+
+        offsets.assign(n + 1, 0);
+        for (size_t i = 1; i < n; ++i) ++offsets[parents[i] + 1];
+        for (size_t i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+        kids.resize(n - 1);
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 1; i < n; ++i) kids[cursor[parents[i]]++] = i;
+
+        // Everything before i in pre-order that is not an ancestor is finished
+        // before i in post-order, and so is i's own subtree.
+        post.resize(n);
+        for (size_t i = 0; i < n; ++i) post[i - depths[i] + sizes[i] - 1] = i;
+
+        size_t levels = 1 + *std::max_element(depths.begin(), depths.end());
+        std::vector<size_t> level_begin(levels + 1, 0);
+        for (size_t depth : depths) ++level_begin[depth + 1];
+        for (size_t d = 0; d < levels; ++d) level_begin[d + 1] += level_begin[d];
+        level.resize(n);
+        for (size_t i = 0; i < n; ++i) level[level_begin[depths[i]]++] = i;
+
+        inorder_sequence();
+    }
+
+    [[nodiscard]] size_t size() const { return data.size(); }
+
+    [[nodiscard]] bool empty() const { return data.empty(); }
+
+    /**
+     * @brief Returns the number of edges on the longest root-to-leaf path, -1 when empty.
+     */
+    [[nodiscard]] int height() const {
+        return empty() ? -1 : static_cast<int>(depths[level.back()]);
+    }
+
+    /**
+     * @brief Returns all values in pre-order.
+     */
+    [[nodiscard]] std::span<const T> values() const { return data; }
+
+    const T &value(size_t id) const { return data[id]; }
+
+    /**
+     * @brief Returns the parent of a node, or npos for the root.
+     */
+    [[nodiscard]] size_t parent(size_t id) const { return parents[id]; }
+
+    [[nodiscard]] size_t depth(size_t id) const { return depths[id]; }
+
+    /**
+     * @brief Returns the ids of a node's children, in order.
+     */
+    [[nodiscard]] std::span<const size_t> children(size_t id) const {
+        return std::span<const size_t>(kids).subspan(offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    /**
+     * @brief Returns one past the last id in the subtree of @p id.
+     */
+    [[nodiscard]] size_t subtree_end(size_t id) const { return ends[id]; }
+
+    [[nodiscard]] size_t subtree_size(size_t id) const { return ends[id] - id; }
+
+    /**
+     * @brief Returns the values of the subtree rooted at @p id, the node first.
+     */
+    [[nodiscard]] std::span<const T> subtree_values(size_t id) const {
+        return std::span<const T>(data).subspan(id, ends[id] - id);
+    }
+
+    /**
+     * @brief Returns whether @p ancestor lies on the path from @p node to the root, in O(1).
+     *
+     * A node counts as its own ancestor.
+     */
+    [[nodiscard]] bool is_ancestor(size_t ancestor, size_t node) const {
+        return ancestor <= node && node < ends[ancestor];
+    }
+
+    /**
+     * @brief Returns the id of the first node in pre-order with the given value, or npos.
+     */
+    [[nodiscard]] size_t find(const T &value) const {
+        auto found = std::find(data.begin(), data.end(), value);
+        return found == data.end() ? npos : static_cast<size_t>(found - data.begin());
+    }
+
+    [[nodiscard]] std::span<const size_t> postorder() const { return post; }
+
+    [[nodiscard]] std::span<const size_t> inorder() const { return in; }
+
+    [[nodiscard]] std::span<const size_t> level_order() const { return level; }
+
+    /**
+     * @brief Yields values either straight from storage or through a precomputed id sequence.
+     */
+    class ScanIterator {
+    public:
+        [[nodiscard]] bool has_next() const {
+            return position < values.size();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+            size_t at = position++;
+            return values[order.empty() ? at : order[at]];
+        }
+
+    private:
+        friend class FrozenTree;
+
+        ScanIterator(std::span<const T> values, std::span<const size_t> order) : values(values), order(order) {}
+
+        std::span<const T> values;
+        std::span<const size_t> order;
+        size_t position = 0;
+    };
+
+    using PreOrderIterator = ScanIterator;
+    using PostOrderIterator = ScanIterator;
+    using InOrderIterator = ScanIterator;
+    using BFSIterator = ScanIterator;
+    using DFSIterator = ScanIterator;
+
+    PreOrderIterator begin_preorder() const { return ScanIterator(data, {}); }
+    PostOrderIterator begin_postorder() const { return ScanIterator(data, post); }
+    InOrderIterator begin_inorder() const { return ScanIterator(data, in); }
+    BFSIterator begin_bfs() const { return ScanIterator(data, level); }
+    DFSIterator begin_dfs() const { return begin_preorder(); }
+
+private:
+    std::vector<T> data;           ///< Values by pre-order id.
+    std::vector<size_t> parents;   ///< Parent id, npos for the root.
+    std::vector<size_t> depths;    ///< Edges to the root.
+    std::vector<size_t> ends;      ///< One past the last id of each subtree.
+    std::vector<size_t> offsets;   ///< Children of i are kids[offsets[i]] ... kids[offsets[i + 1] - 1].
+    std::vector<size_t> kids;
+    std::vector<size_t> post;      ///< Ids in post-order.
+    std::vector<size_t> in;        ///< Ids in in-order: first subtree, node, remaining subtrees.
+    std::vector<size_t> level;     ///< Ids in level order.
+
+    void inorder_sequence() {
+        in.reserve(data.size());
+        std::vector<std::pair<size_t, bool>> pending{{0, false}};
+        while (!pending.empty()) {
+            auto [id, expanded] = pending.back();
+            pending.pop_back();
+            if (expanded) {
+                in.push_back(id);
+                continue;
+            }
+            auto below = children(id);
+            for (size_t k = below.size(); k-- > 1;) pending.emplace_back(below[k], false);
+            pending.emplace_back(id, true);
+            if (!below.empty()) pending.emplace_back(below.front(), false);
+        }
+    }
+};
+
+#endif // FROZEN_TREE_HPP
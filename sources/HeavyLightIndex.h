@@ -0,0 +1,162 @@
+#ifndef HEAVY_LIGHT_INDEX_HPP
+#define HEAVY_LIGHT_INDEX_HPP
+
+#include "SegmentTree.h"
+#include "Tree.h"
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Path aggregate index based on heavy-light decomposition.
+ *
+ * Every node continues the chain of its largest child, so any path crosses
+ * O(log n) chains. Chains are laid out contiguously over a segment tree, which
+ * makes path sum/min/max queries O(log^2 n) and point updates O(log n).
+ *
+ * The index holds raw node pointers, so it must not outlive the tree, and it does
+ * not see nodes added after it was built. Values must only be changed through
+ * set_data() on the index while it is in use.
+ *
+ * @tparam T An arithmetic-like type supporting +, < and copy.
+ * @tparam N The maximum number of children each node can have.
+ */
+template<typename T, int N = 2>
+class HeavyLightIndex {
+public:
+    /**
+     * @brief Builds the decomposition for the given tree in O(n).
+     *
+     * @param tree The tree to index.
+     */
+    explicit HeavyLightIndex(const Tree<T, N> &tree) {
+        if (!tree.root) return;
+        number_nodes(tree.root.get());
+        choose_heavy_children();
+        lay_out_chains();
+    }
+
+    /**
+     * @brief Summarizes the values on the path between two nodes, both ends included.
+     *
+     * @throws std::invalid_argument If either node is not part of the indexed tree.
+     */
+    RangeSummary<T> path(const Node<T> *from, const Node<T> *to) const {
+        size_t u = id_of(from);
+        size_t v = id_of(to);
+        std::optional<RangeSummary<T>> result;
+        auto take = [&](size_t first, size_t last) {
+            auto part = segments.query(first, last);
+            if (result) *result += part; else result = part;
+        };
+
+        while (head[u] != head[v]) {
+            if (depth[head[u]] < depth[head[v]]) std::swap(u, v);
+            take(position[head[u]], position[u] + 1);
+            u = parent[head[u]];
+        }
+        if (position[u] > position[v]) std::swap(u, v);
+        take(position[u], position[v] + 1);
+        return *result;
+    }
+
+    T path_sum(const Node<T> *from, const Node<T> *to) const { return path(from, to).sum; }
+
+    T path_min(const Node<T> *from, const Node<T> *to) const { return path(from, to).min; }
+
+    T path_max(const Node<T> *from, const Node<T> *to) const { return path(from, to).max; }
+
+    /**
+     * @brief Summarizes the values on the path from the root down to a node.
+     *
+     * @throws std::invalid_argument If the node is not part of the indexed tree.
+     */
+    RangeSummary<T> path_from_root(const Node<T> *node) const {
+        if (nodes.empty()) throw std::invalid_argument("Node is not part of the indexed tree.");
+        return path(nodes.front(), node);
+    }
+
+    /**
+     * @brief Changes a node's value and updates the index in O(log n).
+     *
+     * @throws std::invalid_argument If the node is not part of the indexed tree.
+     */
+    void set_data(Node<T> *node, const T &value) {
+        size_t id = id_of(node);
+        node->set_data(value);
+        segments.update(position[id], value);
+    }
+
+private:
+    static constexpr size_t none = static_cast<size_t>(-1);
+
+    std::vector<Node<T> *> nodes;      ///< Nodes by id; ids are pre-order positions.
+    std::unordered_map<const Node<T> *, size_t> ids;
+    std::vector<size_t> parent;        ///< Parent id, or none for the root.
+    std::vector<size_t> depth;
+    std::vector<size_t> heavy;         ///< Child with the largest subtree, or none for leaves.
+    std::vector<size_t> head;          ///< Topmost node of each node's chain.
+    std::vector<size_t> position;      ///< Slot of each node in the segment tree.
+    SegmentTree<T> segments;
+
+    void number_nodes(Node<T> *root) {
+        std::vector<std::pair<Node<T> *, size_t>> stack{{root, none}};
+        while (!stack.empty()) {
+            auto [node, up] = stack.back();
+            stack.pop_back();
+            size_t id = nodes.size();
+            nodes.push_back(node);
+            ids.emplace(node, id);
+            parent.push_back(up);
+            depth.push_back(up == none ? 0 : depth[up] + 1);
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) stack.emplace_back(it->get(), id);
+            }
+        }
+    }
+
+    void choose_heavy_children() {
+        std::vector<size_t> size(nodes.size(), 1);
+        heavy.assign(nodes.size(), none);
+        // Children always have larger pre-order ids than their parent.
+        for (size_t id = nodes.size() - 1; id > 0; --id) {
+            size_t up = parent[id];
+            size[up] += size[id];
+            if (heavy[up] == none || size[id] > size[heavy[up]]) heavy[up] = id;
+        }
+    }
+
+    void lay_out_chains() {
+        head.assign(nodes.size(), 0);
+        position.assign(nodes.size(), 0);
+        std::vector<T> values;
+        values.reserve(nodes.size());
+
+        std::vector<size_t> chain_starts{0};
+        while (!chain_starts.empty()) {
+            size_t start = chain_starts.back();
+            chain_starts.pop_back();
+            for (size_t id = start; id != none; id = heavy[id]) {
+                head[id] = start;
+                position[id] = values.size();
+                values.push_back(nodes[id]->data);
+                for (const auto &child : nodes[id]->children) {
+                    if (!child) continue;
+                    size_t child_id = ids.at(child.get());
+                    if (child_id != heavy[id]) chain_starts.push_back(child_id);
+                }
+            }
+        }
+        segments = SegmentTree<T>(values);
+    }
+
+    size_t id_of(const Node<T> *node) const {
+        auto found = ids.find(node);
+        if (found == ids.end()) throw std::invalid_argument("Node is not part of the indexed tree.");
+        return found->second;
+    }
+};
+
+#endif // HEAVY_LIGHT_INDEX_HPP
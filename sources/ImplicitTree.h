@@ -0,0 +1,361 @@
+#ifndef IMPLICIT_TREE_HPP
+#define IMPLICIT_TREE_HPP
+
+#include "FlatTree.h"
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A complete k-ary tree stored implicitly in a single values array.
+ *
+ * Nodes are numbered in level order, so child i of node p sits at index p*N+i+1
+ * and the parent of node c sits at (c-1)/N. No child pointers are stored and every
+ * level occupies one contiguous range of the array.
+ *
+ * Node handles are plain indices. The iterators mirror the ones in Tree and walk
+ * the array without any auxiliary container.
+ *
+ * @tparam T The type of the data stored in the tree nodes.
+ * @tparam N The number of children of each inner node. Default is 2.
+ */
+template<typename T, int N = 2>
+class ImplicitTree {
+    static_assert(N > 0, "ImplicitTree needs a positive fanout.");
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t fanout = static_cast<size_t>(N);
+
+    /**
+     * @brief Default constructor.
+     * Initializes an empty tree.
+     */
+    ImplicitTree() = default;
+
+    /**
+     * @brief Constructs a tree from values given in level order.
+     *
+     * @param values The node values, root first, then each level left to right.
+     */
+    explicit ImplicitTree(std::vector<T> values) : values(std::move(values)) {}
+
+    /**
+     * @brief Constructs a tree by copying values given in level order.
+     *
+     * The copy is one contiguous range assignment, which becomes a plain memory
+     * copy for trivially copyable types.
+     *
+     * @param values The node values, root first, then each level left to right.
+     */
+    explicit ImplicitTree(std::span<const T> values) : values(values.begin(), values.end()) {}
+
+    /**
+     * @brief Appends a node at the next free position in level order.
+     *
+     * @param value The value of the new node.
+     */
+    void push_back(const T &value) {
+        values.push_back(value);
+    }
+
+    [[nodiscard]] size_t size() const { return values.size(); }
+
+    [[nodiscard]] bool empty() const { return values.empty(); }
+
+    T &operator[](size_t index) { return values[index]; }
+
+    const T &operator[](size_t index) const { return values[index]; }
+
+    /**
+     * @brief Returns the whole tree as one contiguous level-order span.
+     */
+    [[nodiscard]] std::span<const T> data() const { return values; }
+
+    /**
+     * @brief Exports the tree as flat level-order arrays.
+     *
+     * The storage already is level order, so the values are borrowed rather than
+     * copied; only the parent and offset arrays are computed, in O(n).
+     */
+    [[nodiscard]] FlatTree<T> to_flat() const {
+        std::vector<size_t> parents(values.size());
+        std::vector<size_t> offsets(values.size() + 1);
+        for (size_t i = 0; i < values.size(); ++i) {
+            parents[i] = parent(i);
+            offsets[i] = std::min(i * fanout + 1, values.size());
+        }
+        offsets[values.size()] = values.size();
+        return FlatTree<T>(data(), std::move(parents), std::move(offsets));
+    }
+
+    /**
+     * @brief Returns the index of a node's parent, or npos for the root.
+     */
+    [[nodiscard]] static size_t parent(size_t index) {
+        return index == 0 ? npos : (index - 1) / fanout;
+    }
+
+    /**
+     * @brief Returns the index of a node's i-th child, or npos if it does not exist.
+     */
+    [[nodiscard]] size_t child(size_t index, size_t i) const {
+        size_t position = index * fanout + i + 1;
+        return i < fanout && position < values.size() ? position : npos;
+    }
+
+    /**
+     * @brief Returns the number of children a node actually has.
+     */
+    [[nodiscard]] size_t num_children(size_t index) const {
+        size_t first = index * fanout + 1;
+        if (first >= values.size()) return 0;
+        return std::min(fanout, values.size() - first);
+    }
+
+    /**
+     * @brief Returns the number of levels in the tree.
+     */
+    [[nodiscard]] size_t levels() const {
+        size_t count = 0;
+        while (level_begin(count) < values.size()) ++count;
+        return count;
+    }
+
+    /**
+     * @brief Returns the values on one level as a contiguous span.
+     *
+     * Levels are stored back to back, so a scan over a level is a plain linear
+     * loop the compiler can vectorize.
+     *
+     * @param depth The level to return, 0 being the root.
+     *
+     * @throws std::out_of_range If the tree has no such level.
+     */
+    [[nodiscard]] std::span<const T> level(size_t depth) const {
+        size_t first = level_begin(depth);
+        if (first >= values.size()) throw std::out_of_range("No such level");
+        size_t last = std::min(level_begin(depth + 1), values.size());
+        return std::span<const T>(values).subspan(first, last - first);
+    }
+
+    /**
+     * @brief Walks from the root towards a leaf, letting @p choose pick the child at every step.
+     *
+     * While @p choose inspects the children of the current node, the block of
+     * grandchildren is prefetched so the next step does not stall on memory.
+     *
+     * @param choose Called with the current index and a span of its children's values;
+     *               returns the position of the child to descend into, or npos to stop.
+     *
+     * @return size_t The index of the node the walk stopped at, or npos on an empty tree.
+     */
+    template<typename Choose>
+    size_t descend(Choose &&choose) const {
+        if (values.empty()) return npos;
+        size_t index = 0;
+        while (true) {
+            size_t count = num_children(index);
+            if (count == 0) return index;
+            size_t first = index * fanout + 1;
+            prefetch(first * fanout + 1);
+            size_t pick = choose(index, std::span<const T>(values).subspan(first, count));
+            if (pick == npos || pick >= count) return index;
+            index = first + pick;
+        }
+    }
+
+    /**
+     * @brief Pre-order iterator over an implicit tree; needs no auxiliary storage.
+     */
+    class PreOrderIterator {
+    public:
+        explicit PreOrderIterator(const ImplicitTree &tree) : tree(tree), current(tree.empty() ? npos : 0) {}
+
+        [[nodiscard]] bool has_next() const {
+            return current != npos;
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            size_t index = current;
+            current = tree.child(index, 0);
+            if (current == npos) current = tree.next_sibling_up(index);
+            return tree.values[index];
+        }
+
+    private:
+        const ImplicitTree &tree;
+        size_t current;
+    };
+
+    /**
+     * @brief Post-order iterator over an implicit tree; needs no auxiliary storage.
+     */
+    class PostOrderIterator {
+    public:
+        explicit PostOrderIterator(const ImplicitTree &tree) : tree(tree), current(tree.empty() ? npos : tree.leftmost(0)) {}
+
+        [[nodiscard]] bool has_next() const {
+            return current != npos;
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            size_t index = current;
+            size_t sibling = tree.next_sibling(index);
+            current = sibling != npos ? tree.leftmost(sibling) : parent(index);
+            return tree.values[index];
+        }
+
+    private:
+        const ImplicitTree &tree;
+        size_t current;
+    };
+
+    /**
+     * @brief In-order iterator: first child's subtree, the node, then the remaining subtrees.
+     */
+    class InOrderIterator {
+    public:
+        explicit InOrderIterator(const ImplicitTree &tree) : tree(tree), current(tree.empty() ? npos : tree.leftmost(0)) {}
+
+        [[nodiscard]] bool has_next() const {
+            return current != npos;
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            size_t index = current;
+            size_t second = tree.child(index, 1);
+            current = second != npos ? tree.leftmost(second) : tree.after_subtree(index);
+            return tree.values[index];
+        }
+
+    private:
+        const ImplicitTree &tree;
+        size_t current;
+    };
+
+    /**
+     * @brief BFS iterator; level order is storage order, so this is a linear scan.
+     */
+    class BFSIterator {
+    public:
+        explicit BFSIterator(const ImplicitTree &tree) : tree(tree) {}
+
+        [[nodiscard]] bool has_next() const {
+            return current < tree.size();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+            return tree.values[current++];
+        }
+
+    private:
+        const ImplicitTree &tree;
+        size_t current = 0;
+    };
+
+    using DFSIterator = PreOrderIterator;
+
+    /**
+     * @brief Yields the values in ascending order.
+     */
+    class HeapIterator {
+    public:
+        explicit HeapIterator(const ImplicitTree &tree) : heap(tree.values) {
+            std::make_heap(heap.begin(), heap.end(), std::greater<T>());
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !heap.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            std::pop_heap(heap.begin(), heap.end(), std::greater<T>());
+            T value = std::move(heap.back());
+            heap.pop_back();
+            return value;
+        }
+
+    private:
+        std::vector<T> heap;
+    };
+
+    PreOrderIterator begin_preorder() const { return PreOrderIterator(*this); }
+    PostOrderIterator begin_postorder() const { return PostOrderIterator(*this); }
+    InOrderIterator begin_inorder() const { return InOrderIterator(*this); }
+    BFSIterator begin_bfs() const { return BFSIterator(*this); }
+    DFSIterator begin_dfs() const { return DFSIterator(*this); }
+    HeapIterator begin_heap() const { return HeapIterator(*this); }
+
+private:
+    std::vector<T> values;
+
+    /**
+        * @brief Index of the first node on the given level: (N^depth - 1) / (N - 1).
+        */
+    [[nodiscard]] size_t level_begin(size_t depth) const {
+        size_t first = 0;
+        size_t width = 1;
+        for (size_t d = 0; d < depth; ++d) {
+            first += width;
+            if (first >= values.size()) return values.size() + 1;
+            width *= fanout;
+        }
+        return first;
+    }
+
+    void prefetch(size_t index) const {
+#if defined(__GNUC__)
+        if (index < values.size()) __builtin_prefetch(&values[index]);
+#else
+        (void) index;
+#endif
+    }
+
+    [[nodiscard]] size_t next_sibling(size_t index) const {
+        if (index == 0 || index % fanout == 0 || index + 1 >= values.size()) return npos;
+        return index + 1;
+    }
+
+    [[nodiscard]] size_t next_sibling_up(size_t index) const {
+        while (index != npos) {
+            size_t sibling = next_sibling(index);
+            if (sibling != npos) return sibling;
+            index = parent(index);
+        }
+        return npos;
+    }
+
+    [[nodiscard]] size_t leftmost(size_t index) const {
+        for (size_t first = child(index, 0); first != npos; first = child(index, 0)) index = first;
+        return index;
+    }
+
+    /**
+        * @brief The in-order successor once the subtree rooted at @p index is fully visited.
+        */
+    [[nodiscard]] size_t after_subtree(size_t index) const {
+        while (index != 0) {
+            size_t up = parent(index);
+            if ((index - 1) % fanout == 0) return up;
+            size_t sibling = next_sibling(index);
+            if (sibling != npos) return leftmost(sibling);
+            index = up;
+        }
+        return npos;
+    }
+};
+
+#endif // IMPLICIT_TREE_HPP
@@ -0,0 +1,201 @@
+#ifndef KARY_HEAP_HPP
+#define KARY_HEAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A k-ary min-heap stored implicitly in one contiguous array.
+ *
+ * Children of slot p sit at p*N+1 ... p*N+N, the same layout as ImplicitTree, so a
+ * fanout of 4 or 8 keeps all children of a node within one or two cache lines
+ * and halves or thirds the height compared to a binary heap.
+ *
+ * push() returns a handle that stays valid until the element is popped and can be
+ * passed to decrease_key(). Handles of popped elements are reused by later pushes.
+ *
+ * @tparam T The type of the elements.
+ * @tparam N The fanout of the heap. Default is 4.
+ * @tparam Compare Strict weak ordering; top() is an element no other compares less than.
+ */
+template<typename T, int N = 4, typename Compare = std::less<T>>
+class KaryHeap {
+    static_assert(N >= 2, "A heap needs a fanout of at least 2.");
+
+public:
+    using Handle = size_t;
+
+    /**
+     * @brief Constructs an empty heap.
+     */
+    explicit KaryHeap(Compare compare = Compare()) : less(std::move(compare)) {}
+
+    /**
+     * @brief Builds a heap from the given values in O(n).
+     *
+     * The element at input position i gets handle i.
+     *
+     * @param values The initial elements.
+     */
+    explicit KaryHeap(std::vector<T> values, Compare compare = Compare()) : less(std::move(compare)) {
+        keys = std::move(values);
+        handles.resize(keys.size());
+        positions.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            handles[i] = i;
+            positions[i] = i;
+        }
+        for (size_t i = keys.size() / fanout + 1; i-- > 0;) {
+            sift_down(i);
+        }
+    }
+
+    [[nodiscard]] bool empty() const { return keys.empty(); }
+
+    [[nodiscard]] size_t size() const { return keys.size(); }
+
+    /**
+     * @brief Returns the smallest element.
+     *
+     * @throws std::out_of_range If the heap is empty.
+     */
+    const T &top() const {
+        if (empty()) throw std::out_of_range("Heap is empty");
+        return keys.front();
+    }
+
+    /**
+     * @brief Returns the handle of the smallest element.
+     *
+     * @throws std::out_of_range If the heap is empty.
+     */
+    [[nodiscard]] Handle top_handle() const {
+        if (empty()) throw std::out_of_range("Heap is empty");
+        return handles.front();
+    }
+
+    /**
+     * @brief Adds an element in O(log_N n).
+     *
+     * @return Handle A handle for decrease_key().
+     */
+    Handle push(T value) {
+        Handle handle;
+        if (free_handles.empty()) {
+            handle = positions.size();
+            positions.push_back(keys.size());
+        } else {
+            handle = free_handles.back();
+            free_handles.pop_back();
+            positions[handle] = keys.size();
+        }
+        keys.push_back(std::move(value));
+        handles.push_back(handle);
+        sift_up(keys.size() - 1);
+        return handle;
+    }
+
+    /**
+     * @brief Removes the smallest element in O(N log_N n).
+     *
+     * @throws std::out_of_range If the heap is empty.
+     */
+    void pop() {
+        if (empty()) throw std::out_of_range("Heap is empty");
+
+        positions[handles.front()] = npos;
+        free_handles.push_back(handles.front());
+        if (keys.size() > 1) {
+            keys.front() = std::move(keys.back());
+            handles.front() = handles.back();
+            positions[handles.front()] = 0;
+        }
+        keys.pop_back();
+        handles.pop_back();
+        if (!keys.empty()) sift_down(0);
+    }
+
+    /**
+     * @brief Lowers the value of an element still in the heap, in O(log_N n).
+     *
+     * @throws std::invalid_argument If the handle is not in the heap or the value is larger.
+     */
+    void decrease_key(Handle handle, T value) {
+        if (!contains(handle)) throw std::invalid_argument("Handle is not in the heap.");
+        size_t slot = positions[handle];
+        if (less(keys[slot], value)) throw std::invalid_argument("New value is larger than the current one.");
+        keys[slot] = std::move(value);
+        sift_up(slot);
+    }
+
+    /**
+     * @brief Returns whether a handle refers to an element still in the heap.
+     */
+    [[nodiscard]] bool contains(Handle handle) const {
+        return handle < positions.size() && positions[handle] != npos;
+    }
+
+    /**
+     * @brief Returns the current value of an element still in the heap.
+     *
+     * @throws std::invalid_argument If the handle is not in the heap.
+     */
+    const T &value(Handle handle) const {
+        if (!contains(handle)) throw std::invalid_argument("Handle is not in the heap.");
+        return keys[positions[handle]];
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t fanout = static_cast<size_t>(N);
+
+    // Keys and handles are kept in separate arrays so the comparisons in a sift
+    // only touch the densely packed keys.
+    std::vector<T> keys;                ///< The heap array.
+    std::vector<Handle> handles;        ///< Handle of the element in each slot.
+    std::vector<size_t> positions;      ///< Slot of each handle, or npos once popped.
+    std::vector<Handle> free_handles;
+    Compare less;
+
+    void place(size_t slot, T key, Handle handle) {
+        positions[handle] = slot;
+        keys[slot] = std::move(key);
+        handles[slot] = handle;
+    }
+
+    void sift_up(size_t slot) {
+        T key = std::move(keys[slot]);
+        Handle handle = handles[slot];
+        while (slot > 0) {
+            size_t parent = (slot - 1) / fanout;
+            if (!less(key, keys[parent])) break;
+            place(slot, std::move(keys[parent]), handles[parent]);
+            slot = parent;
+        }
+        place(slot, std::move(key), handle);
+    }
+
+    void sift_down(size_t slot) {
+        if (slot >= keys.size()) return;
+        T key = std::move(keys[slot]);
+        Handle handle = handles[slot];
+        while (true) {
+            size_t first = slot * fanout + 1;
+            if (first >= keys.size()) break;
+            size_t last = std::min(first + fanout, keys.size());
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (less(keys[child], keys[best])) best = child;
+            }
+            if (!less(keys[best], key)) break;
+            place(slot, std::move(keys[best]), handles[best]);
+            slot = best;
+        }
+        place(slot, std::move(key), handle);
+    }
+};
+
+#endif // KARY_HEAP_HPP
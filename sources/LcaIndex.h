@@ -0,0 +1,170 @@
+#ifndef LCA_INDEX_HPP
+#define LCA_INDEX_HPP
+
+#include "Tree.h"
+#include <bit>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Lowest-common-ancestor index over a tree that no longer changes.
+ *
+ * Built in O(n log n) from an Euler tour of the tree and a sparse table of
+ * range minima over the tour depths. Each query is then two table lookups, O(1).
+ * The index holds raw node pointers, so it must not outlive the tree, and it
+ * does not see nodes added after it was built.
+ *
+ * @tparam T The type of the data stored in the tree nodes.
+ * @tparam N The maximum number of children each node can have.
+ */
+template<typename T, int N = 2>
+class LcaIndex {
+public:
+    using NodePair = std::pair<const Node<T> *, const Node<T> *>;
+
+    /**
+     * @brief Builds the index for the given tree.
+     *
+     * @param tree The tree to index.
+     */
+    explicit LcaIndex(const Tree<T, N> &tree) {
+        if (!tree.root) return;
+        euler_tour(tree.root.get());
+        build_sparse_table();
+    }
+
+    /**
+     * @brief Returns the lowest common ancestor of two nodes in O(1).
+     *
+     * A node counts as its own ancestor.
+     *
+     * @throws std::invalid_argument If either node is not part of the indexed tree.
+     */
+    Node<T> *lca(const Node<T> *a, const Node<T> *b) const {
+        size_t left = first_visit(a);
+        size_t right = first_visit(b);
+        if (left > right) std::swap(left, right);
+
+        const auto level = static_cast<size_t>(std::bit_width(right - left + 1) - 1);
+        size_t low = table[level][left];
+        size_t high = table[level][right + 1 - (size_t{1} << level)];
+        return nodes[depths[low] <= depths[high] ? low : high];
+    }
+
+    /**
+     * @brief Returns the lowest common ancestor of the first nodes, in pre-order, holding two values.
+     *
+     * @throws std::invalid_argument If either value is not in the indexed tree.
+     */
+    Node<T> *lca(const T &a, const T &b) const {
+        return lca(node_of(a), node_of(b));
+    }
+
+    /**
+     * @brief Answers a batch of queries.
+     *
+     * @param queries Pairs of nodes of the indexed tree.
+     *
+     * @return std::vector<Node<T> *> The lowest common ancestor of each pair, in input order.
+     */
+    std::vector<Node<T> *> lca_batch(std::span<const NodePair> queries) const {
+        std::vector<Node<T> *> answers;
+        answers.reserve(queries.size());
+        for (const auto &query : queries) {
+            answers.push_back(lca(query.first, query.second));
+        }
+        return answers;
+    }
+
+    /**
+     * @brief Returns the depth of an indexed node in O(1).
+     *
+     * @throws std::invalid_argument If the node is not part of the indexed tree.
+     */
+    [[nodiscard]] int depth(const Node<T> *node) const {
+        return depths[tour[first_visit(node)]];
+    }
+
+private:
+    std::vector<Node<T> *> nodes;                       ///< Nodes by id; ids are pre-order positions.
+    std::vector<int> depths;                            ///< Depth of each node by id.
+    std::vector<size_t> tour;                           ///< Node ids in Euler tour order.
+    std::unordered_map<const Node<T> *, size_t> first;  ///< First tour position of each node.
+    std::vector<std::vector<size_t>> table;             ///< table[k][i]: shallowest node id in tour[i, i + 2^k).
+    [[no_unique_address]] std::conditional_t<Hashable<T>, std::unordered_map<T, size_t>, std::monostate>
+            by_value;                                   ///< First node id holding each value, for hashable T.
+
+    struct Frame {
+        Node<T> *node;
+        size_t id;
+        size_t next_child;
+    };
+
+    void euler_tour(Node<T> *root) {
+        std::vector<Frame> stack{{root, visit(root, 0), 0}};
+        while (!stack.empty()) {
+            Frame &frame = stack.back();
+            const auto &children = frame.node->children;
+            while (frame.next_child < children.size() && !children[frame.next_child]) ++frame.next_child;
+            if (frame.next_child == children.size()) {
+                stack.pop_back();
+                if (!stack.empty()) tour.push_back(stack.back().id);
+                continue;
+            }
+            Node<T> *child = children[frame.next_child++].get();
+            size_t id = visit(child, static_cast<int>(stack.size()));
+            stack.push_back({child, id, 0});
+        }
+    }
+
+    size_t visit(Node<T> *node, int depth) {
+        size_t id = nodes.size();
+        nodes.push_back(node);
+        depths.push_back(depth);
+        first.emplace(node, tour.size());
+        tour.push_back(id);
+        if constexpr (Hashable<T>) {
+            by_value.emplace(node->data, id);
+        }
+        return id;
+    }
+
+    void build_sparse_table() {
+        table.push_back(tour);
+        for (size_t width = 2; width <= tour.size(); width *= 2) {
+            const auto &previous = table.back();
+            std::vector<size_t> level(tour.size() - width + 1);
+            for (size_t i = 0; i < level.size(); ++i) {
+                size_t low = previous[i];
+                size_t high = previous[i + width / 2];
+                level[i] = depths[low] <= depths[high] ? low : high;
+            }
+            table.push_back(std::move(level));
+        }
+    }
+
+    size_t first_visit(const Node<T> *node) const {
+        auto found = first.find(node);
+        if (found == first.end()) throw std::invalid_argument("Node is not part of the indexed tree.");
+        return found->second;
+    }
+
+    const Node<T> *node_of(const T &value) const {
+        if constexpr (Hashable<T>) {
+            auto found = by_value.find(value);
+            if (found != by_value.end()) return nodes[found->second];
+        } else {
+            for (const auto *node : nodes) {
+                if (node->data == value) return node;
+            }
+        }
+        throw std::invalid_argument("Value is not in the indexed tree.");
+    }
+};
+
+#endif // LCA_INDEX_HPP
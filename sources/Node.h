@@ -1,9 +1,32 @@
 #ifndef NODE_HPP
 #define NODE_HPP
 
+#include <array>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
+/**
+ * @brief Smallest and largest value in a node's subtree.
+ *
+ * Only arithmetic value types carry bounds; for any other type this is empty and
+ * takes no space in the node.
+ *
+ * @tparam T The data type of the elements stored in the tree nodes.
+ */
+template<typename T, bool = std::is_arithmetic_v<T>>
+struct SubtreeBounds {
+    T min; ///< Smallest value in the subtree.
+    T max; ///< Largest value in the subtree.
+
+    explicit SubtreeBounds(const T &value) : min(value), max(value) {}
+};
+
+template<typename T>
+struct SubtreeBounds<T, false> {
+    explicit SubtreeBounds(const T &) {}
+};
+
 /**
  * @brief This class represents a node in a tree data structure.
  *
@@ -16,13 +39,18 @@ public:
     int numOfChildren = 0; ///< The current number of children this node has.
 
     std::vector<std::shared_ptr<Node<T>>> children; ///< Dynamic array of shared pointers to the node's children.
+    std::array<Node<T> *, 2> links{}; ///< Raw left/right child links, maintained only by binary trees.
+    Node<T> *parent = nullptr; ///< Non-owning link to the parent node, nullptr for the root.
+    int depth = 0; ///< Number of edges between this node and the root.
+    size_t subtree_size = 1; ///< Number of nodes in this node's subtree, kept when the tree tracks subtree sizes.
+    [[no_unique_address]] SubtreeBounds<T> bounds; ///< Subtree value range, kept when the tree tracks value bounds.
 
     /**
      * @brief Construct a new Node object with the given data.
      *
      * @param value The data value to store in this node.
      */
-    explicit Node(T value) : data(value) {}
+    explicit Node(T value) : data(value), bounds(data) {}
 
     /**
      * @brief Resizes the children vector to a specified size and initializes them to nullptr.
@@ -41,6 +69,25 @@ public:
     void set_data(T value) {
         data = value;
     }
+
+    /**
+     * @brief Returns the left child of a binary tree node, or nullptr.
+     */
+    Node<T> *left() const { return links[0]; }
+
+    /**
+     * @brief Returns the right child of a binary tree node, or nullptr.
+     */
+    Node<T> *right() const { return links[1]; }
+
+    /**
+     * @brief Branchless child selection for binary tree nodes.
+     *
+     * @param go_right Whether to return the right child instead of the left one.
+     *
+     * @return Node<T>* The selected child, or nullptr.
+     */
+    Node<T> *side(bool go_right) const { return links[static_cast<size_t>(go_right)]; }
 };
 
 #endif // NODE_HPP
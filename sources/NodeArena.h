@@ -0,0 +1,153 @@
+#ifndef NODE_ARENA_HPP
+#define NODE_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A bump-pointer arena that hands out node storage in contiguous blocks.
+ *
+ * Nodes allocated one after the other end up next to each other in memory, so a
+ * traversal that follows allocation order touches memory sequentially.
+ * Released slots are kept on per-size free lists and handed out again before
+ * the arena grows. The arena is not thread-safe.
+ */
+class NodeArena {
+public:
+    /**
+     * @brief Construct an arena that grows in blocks of the given size.
+     *
+     * @param block_bytes The size of each block requested from the system.
+     */
+    explicit NodeArena(size_t block_bytes = 64 * 1024) : block_bytes(block_bytes) {}
+
+    NodeArena(const NodeArena &) = delete;
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    /**
+     * @brief Allocates storage for one object.
+     *
+     * @param bytes The size of the object.
+     * @param align The required alignment of the object.
+     *
+     * @return void* Pointer to uninitialized storage.
+     */
+    void *allocate(size_t bytes, size_t align) {
+        bytes = slot_size(bytes);
+        for (auto &list : free_lists) {
+            if (list.first == bytes && list.second) {
+                FreeSlot *slot = list.second;
+                list.second = slot->next;
+                return slot;
+            }
+        }
+
+        auto aligned = align_up(cursor, align);
+        if (!cursor || aligned + bytes > end) {
+            grow(bytes + align);
+            aligned = align_up(cursor, align);
+        }
+        cursor = aligned + bytes;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    /**
+     * @brief Returns storage to the arena so it can be reused by a later allocation.
+     *
+     * @param ptr Pointer previously returned by allocate().
+     * @param bytes The size passed to allocate().
+     */
+    void deallocate(void *ptr, size_t bytes) {
+        bytes = slot_size(bytes);
+        auto *slot = static_cast<FreeSlot *>(ptr);
+        for (auto &list : free_lists) {
+            if (list.first == bytes) {
+                slot->next = list.second;
+                list.second = slot;
+                return;
+            }
+        }
+        slot->next = nullptr;
+        free_lists.emplace_back(bytes, slot);
+    }
+
+    /**
+     * @brief Makes sure the next @p bytes of allocations come from a single block.
+     *
+     * @param bytes The number of bytes about to be allocated.
+     */
+    void reserve(size_t bytes) {
+        if (!cursor || static_cast<size_t>(end - cursor) < bytes) {
+            grow(bytes);
+        }
+    }
+
+private:
+    struct FreeSlot {
+        FreeSlot *next;
+    };
+
+    size_t block_bytes;
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::uintptr_t cursor = 0;
+    std::uintptr_t end = 0;
+    std::vector<std::pair<size_t, FreeSlot *>> free_lists;
+
+    static size_t slot_size(size_t bytes) {
+        return bytes < sizeof(FreeSlot) ? sizeof(FreeSlot) : bytes;
+    }
+
+    static std::uintptr_t align_up(std::uintptr_t address, size_t align) {
+        return (address + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+    }
+
+    void grow(size_t at_least) {
+        size_t size = at_least > block_bytes ? at_least : block_bytes;
+        blocks.push_back(std::make_unique<std::byte[]>(size));
+        cursor = reinterpret_cast<std::uintptr_t>(blocks.back().get());
+        end = cursor + size;
+    }
+};
+
+/**
+ * @brief Standard allocator adaptor over a shared NodeArena.
+ *
+ * Every allocator copy keeps the arena alive, so nodes created with
+ * std::allocate_shared may safely outlive the tree that created them.
+ *
+ * @tparam U The type of object being allocated.
+ */
+template<typename U>
+class ArenaAllocator {
+public:
+    using value_type = U;
+
+    explicit ArenaAllocator(std::shared_ptr<NodeArena> arena) : arena(std::move(arena)) {}
+
+    template<typename V>
+    ArenaAllocator(const ArenaAllocator<V> &other) : arena(other.arena) {}
+
+    U *allocate(size_t n) {
+        return static_cast<U *>(arena->allocate(n * sizeof(U), alignof(U)));
+    }
+
+    void deallocate(U *ptr, size_t n) {
+        arena->deallocate(ptr, n * sizeof(U));
+    }
+
+    template<typename V>
+    bool operator==(const ArenaAllocator<V> &other) const { return arena == other.arena; }
+
+    template<typename V>
+    bool operator!=(const ArenaAllocator<V> &other) const { return arena != other.arena; }
+
+private:
+    template<typename V> friend class ArenaAllocator;
+
+    std::shared_ptr<NodeArena> arena;
+};
+
+#endif // NODE_ARENA_HPP
@@ -0,0 +1,200 @@
+#ifndef ORDERED_TREE_HPP
+#define ORDERED_TREE_HPP
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A k-ary search tree (B-tree) over ordered keys.
+ *
+ * Every node has at most N children and N - 1 keys kept in sorted order, and all
+ * leaves sit on the same level. That keeps the height logarithmic, so find,
+ * lower_bound and insert are O(log n) and an in-order walk yields the keys sorted.
+ * Keys are unique; inserting an existing key is a no-op.
+ *
+ * @tparam T The key type; must be copyable and ordered by operator<.
+ * @tparam N The maximum number of children each node can have; at least 3.
+ */
+template<typename T, int N = 3>
+class OrderedTree {
+    static_assert(N >= 3, "An ordered tree needs a fanout of at least 3 to stay balanced.");
+
+    static constexpr size_t max_keys = static_cast<size_t>(N) - 1;
+
+    struct BNode {
+        std::vector<T> keys;
+        std::vector<std::unique_ptr<BNode>> children; ///< Empty for leaves, keys.size() + 1 otherwise.
+
+        [[nodiscard]] bool is_leaf() const { return children.empty(); }
+
+        [[nodiscard]] size_t lower_index(const T &key) const {
+            return static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+        }
+    };
+
+public:
+    /**
+     * @brief Sorted iterator over the keys, starting at a given position.
+     */
+    class InOrderIterator {
+    public:
+        [[nodiscard]] bool has_next() const {
+            return !stack.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            auto [node, index] = stack.back();
+            T key = node->keys[index];
+            if (index + 1 == node->keys.size()) {
+                stack.pop_back();
+            } else {
+                ++stack.back().second;
+            }
+            if (!node->is_leaf()) push_left(node->children[index + 1].get());
+            return key;
+        }
+
+    private:
+        friend class OrderedTree;
+
+        std::vector<std::pair<const BNode *, size_t>> stack; ///< Nodes with keys left to visit, next key index.
+
+        void push_left(const BNode *node) {
+            for (; node; node = node->is_leaf() ? nullptr : node->children.front().get()) {
+                stack.emplace_back(node, 0);
+            }
+        }
+    };
+
+    /**
+     * @brief Inserts a key in O(log n).
+     *
+     * @param key The key to insert.
+     *
+     * @return bool Whether the key was inserted; false if it was already present.
+     */
+    bool insert(const T &key) {
+        if (!root) {
+            root = std::make_unique<BNode>();
+            root->keys.reserve(max_keys + 1);
+        }
+
+        std::vector<std::pair<BNode *, size_t>> path;
+        BNode *node = root.get();
+        while (true) {
+            size_t index = node->lower_index(key);
+            if (index < node->keys.size() && !(key < node->keys[index])) return false;
+            if (node->is_leaf()) {
+                node->keys.insert(node->keys.begin() + static_cast<std::ptrdiff_t>(index), key);
+                break;
+            }
+            path.emplace_back(node, index);
+            node = node->children[index].get();
+        }
+        ++count;
+
+        while (node->keys.size() > max_keys) {
+            if (path.empty()) {
+                auto grown = std::make_unique<BNode>();
+                grown->children.push_back(std::move(root));
+                root = std::move(grown);
+                path.emplace_back(root.get(), 0);
+                ++levels;
+            }
+            auto [parent, slot] = path.back();
+            path.pop_back();
+            split_child(parent, slot);
+            node = parent;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Finds a key in O(log n).
+     *
+     * @return const T* The stored key, or nullptr if absent.
+     */
+    const T *find(const T &key) const {
+        for (const BNode *node = root.get(); node;) {
+            size_t index = node->lower_index(key);
+            if (index < node->keys.size() && !(key < node->keys[index])) return &node->keys[index];
+            node = node->is_leaf() ? nullptr : node->children[index].get();
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] bool contains(const T &key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief Returns a sorted iterator starting at the first key not less than @p key, in O(log n).
+     */
+    InOrderIterator lower_bound(const T &key) const {
+        InOrderIterator it;
+        for (const BNode *node = root.get(); node;) {
+            size_t index = node->lower_index(key);
+            if (index < node->keys.size()) it.stack.emplace_back(node, index);
+            node = node->is_leaf() ? nullptr : node->children[index].get();
+        }
+        return it;
+    }
+
+    /**
+     * @brief Collects the keys in [lo, hi] in sorted order, in O(log n + k).
+     */
+    std::vector<T> range(const T &lo, const T &hi) const {
+        std::vector<T> keys;
+        for (auto it = lower_bound(lo); it.has_next();) {
+            T key = it.next();
+            if (hi < key) break;
+            keys.push_back(std::move(key));
+        }
+        return keys;
+    }
+
+    InOrderIterator begin_inorder() const {
+        InOrderIterator it;
+        if (root && !root->keys.empty()) it.push_left(root.get());
+        return it;
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+
+    /**
+     * @brief Returns the number of edges from the root to any leaf, or -1 when empty.
+     */
+    [[nodiscard]] int height() const { return count == 0 ? -1 : levels; }
+
+private:
+    std::unique_ptr<BNode> root;
+    size_t count = 0;
+    int levels = 0;
+
+    /**
+     * @brief Splits an overfull child around its middle key, moving that key up into @p parent.
+     */
+    static void split_child(BNode *parent, size_t slot) {
+        BNode *full = parent->children[slot].get();
+        size_t middle = full->keys.size() / 2;
+
+        auto right = std::make_unique<BNode>();
+        right->keys.reserve(max_keys + 1);
+        right->keys.assign(std::make_move_iterator(full->keys.begin() + static_cast<std::ptrdiff_t>(middle) + 1),
+                           std::make_move_iterator(full->keys.end()));
+        if (!full->is_leaf()) {
+            right->children.assign(std::make_move_iterator(full->children.begin() + static_cast<std::ptrdiff_t>(middle) + 1),
+                                   std::make_move_iterator(full->children.end()));
+            full->children.erase(full->children.begin() + static_cast<std::ptrdiff_t>(middle) + 1, full->children.end());
+        }
+
+        parent->keys.insert(parent->keys.begin() + static_cast<std::ptrdiff_t>(slot), std::move(full->keys[middle]));
+        full->keys.erase(full->keys.begin() + static_cast<std::ptrdiff_t>(middle), full->keys.end());
+        parent->children.insert(parent->children.begin() + static_cast<std::ptrdiff_t>(slot) + 1, std::move(right));
+    }
+};
+
+#endif // ORDERED_TREE_HPP
@@ -0,0 +1,104 @@
+#ifndef PERSISTENT_TREE_HPP
+#define PERSISTENT_TREE_HPP
+
+#include "CowTree.h"
+#include <utility>
+
+/**
+ * @brief An immutable k-ary tree where every update yields a new version.
+ *
+ * Updates never change a version in place: they return a new version that
+ * shares every untouched subtree with the old one and owns fresh copies of the
+ * O(depth) nodes on the updated path. Old versions stay fully usable through the
+ * usual iterators, and nodes no version can reach any more are freed
+ * automatically once the last version referencing them is gone.
+ *
+ * Nodes are addressed by child-index paths from the root, as in CowTree.
+ *
+ * @tparam T The type of the data stored in the tree nodes.
+ * @tparam N The maximum number of children each node can have. Default is 2.
+ */
+template<typename T, int N = 2>
+class PersistentTree {
+public:
+    using Path = typename CowTree<T, N>::Path;
+    using PreOrderIterator = typename CowTree<T, N>::PreOrderIterator;
+    using PostOrderIterator = typename CowTree<T, N>::PostOrderIterator;
+    using InOrderIterator = typename CowTree<T, N>::InOrderIterator;
+    using BFSIterator = typename CowTree<T, N>::BFSIterator;
+    using DFSIterator = typename CowTree<T, N>::DFSIterator;
+
+    /**
+     * @brief Default constructor.
+     * Initializes an empty version.
+     */
+    PersistentTree() = default;
+
+    /**
+     * @brief Creates a version holding only a root with the given value.
+     */
+    explicit PersistentTree(const T &root_value) {
+        tree.add_root(root_value);
+    }
+
+    /**
+     * @brief Creates a version with the same shape and values as @p source.
+     */
+    explicit PersistentTree(const Tree<T, N> &source) : tree(source) {}
+
+    [[nodiscard]] size_t size() const { return tree.size(); }
+
+    [[nodiscard]] bool empty() const { return tree.empty(); }
+
+    /**
+     * @brief Returns the value of the node at @p path.
+     *
+     * @throws std::out_of_range If no node sits at the path.
+     */
+    const T &get(const Path &path) const { return tree.get(path); }
+
+    [[nodiscard]] size_t num_children(const Path &path) const { return tree.num_children(path); }
+
+    /**
+     * @brief Returns whether this version and @p other share the subtree at @p path.
+     */
+    [[nodiscard]] bool shares_subtree(const PersistentTree &other, const Path &path) const {
+        return tree.shares_subtree(other.tree, path);
+    }
+
+    /**
+     * @brief Returns a new version in which the node at @p path holds @p value.
+     *
+     * @throws std::out_of_range If no node sits at the path.
+     */
+    [[nodiscard]] PersistentTree set_data(const Path &path, const T &value) const {
+        PersistentTree next(*this);
+        next.tree.set_data(path, value);
+        return next;
+    }
+
+    /**
+     * @brief Returns a new version in which the node at @p path has one more, last child.
+     *
+     * The new child sits at @p path extended by num_children(path) of this version.
+     *
+     * @throws std::out_of_range If no node sits at the path.
+     * @throws std::runtime_error If the node has reached the maximum number of children.
+     */
+    [[nodiscard]] PersistentTree add_child(const Path &path, const T &value) const {
+        PersistentTree next(*this);
+        next.tree.add_child(path, value);
+        return next;
+    }
+
+    PreOrderIterator begin_preorder() const { return tree.begin_preorder(); }
+    PostOrderIterator begin_postorder() const { return tree.begin_postorder(); }
+    InOrderIterator begin_inorder() const { return tree.begin_inorder(); }
+    BFSIterator begin_bfs() const { return tree.begin_bfs(); }
+    DFSIterator begin_dfs() const { return tree.begin_dfs(); }
+
+private:
+    CowTree<T, N> tree; ///< Never mutated once shared, so every mutation path-copies.
+};
+
+#endif // PERSISTENT_TREE_HPP
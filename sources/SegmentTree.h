@@ -0,0 +1,96 @@
+#ifndef SEGMENT_TREE_HPP
+#define SEGMENT_TREE_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Sum, minimum, maximum and count of a range of values.
+ *
+ * @tparam T An arithmetic-like type supporting +, < and copy.
+ */
+template<typename T>
+struct RangeSummary {
+    T sum;
+    T min;
+    T max;
+    size_t count;
+
+    explicit RangeSummary(const T &value) : sum(value), min(value), max(value), count(1) {}
+
+    RangeSummary &operator+=(const RangeSummary &other) {
+        sum = sum + other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        count += other.count;
+        return *this;
+    }
+};
+
+/**
+ * @brief Bottom-up segment tree keeping a RangeSummary for every range of a fixed-size array.
+ *
+ * Point updates and range queries both run in O(log n).
+ *
+ * @tparam T An arithmetic-like type supporting +, < and copy.
+ */
+template<typename T>
+class SegmentTree {
+public:
+    SegmentTree() = default;
+
+    /**
+     * @brief Builds the tree over the given values in O(n).
+     *
+     * @param values The values, by position.
+     */
+    explicit SegmentTree(const std::vector<T> &values) : leaves(values.size()) {
+        if (values.empty()) return;
+        nodes.reserve(2 * leaves);
+        nodes.insert(nodes.end(), leaves, RangeSummary<T>(values.front()));
+        for (const auto &value : values) nodes.emplace_back(value);
+        for (size_t i = leaves - 1; i > 0; --i) {
+            nodes[i] = nodes[2 * i];
+            nodes[i] += nodes[2 * i + 1];
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return leaves; }
+
+    /**
+     * @brief Replaces the value at one position.
+     *
+     * @throws std::out_of_range If the position is outside the array.
+     */
+    void update(size_t position, const T &value) {
+        if (position >= leaves) throw std::out_of_range("Position outside the segment tree");
+        size_t i = position + leaves;
+        nodes[i] = RangeSummary<T>(value);
+        for (i /= 2; i > 0; i /= 2) {
+            nodes[i] = nodes[2 * i];
+            nodes[i] += nodes[2 * i + 1];
+        }
+    }
+
+    /**
+     * @brief Summarizes the values in positions [first, last).
+     *
+     * @throws std::out_of_range If the range is empty or outside the array.
+     */
+    RangeSummary<T> query(size_t first, size_t last) const {
+        if (first >= last || last > leaves) throw std::out_of_range("Invalid segment tree range");
+        RangeSummary<T> result = nodes[first + leaves];
+        for (size_t left = first + leaves + 1, right = last + leaves; left < right; left /= 2, right /= 2) {
+            if (left & 1) result += nodes[left++];
+            if (right & 1) result += nodes[--right];
+        }
+        return result;
+    }
+
+private:
+    size_t leaves = 0;
+    std::vector<RangeSummary<T>> nodes; ///< nodes[i] combines nodes[2i] and nodes[2i+1]; leaves start at nodes[leaves].
+};
+
+#endif // SEGMENT_TREE_HPP
@@ -0,0 +1,136 @@
+#ifndef SUBTREE_INDEX_HPP
+#define SUBTREE_INDEX_HPP
+
+#include "FenwickTree.h"
+#include "SegmentTree.h"
+#include "Tree.h"
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Subtree aggregate index: sum, min, max and count of any subtree in O(log n).
+ *
+ * Nodes are numbered in pre-order, which makes every subtree a contiguous range
+ * of ids. A segment tree over the values in that order answers range summaries,
+ * and point updates through set_data() keep it current in O(log n).
+ *
+ * The index holds raw node pointers, so it must not outlive the tree, and it does
+ * not see nodes added after it was built. Values must only be changed through
+ * set_data() on the index while it is in use.
+ *
+ * @tparam T An arithmetic-like type supporting +, < and copy.
+ * @tparam N The maximum number of children each node can have.
+ */
+template<typename T, int N = 2>
+class SubtreeIndex {
+public:
+    /**
+     * @brief Builds the index for the given tree in O(n).
+     *
+     * @param tree The tree to index.
+     */
+    explicit SubtreeIndex(const Tree<T, N> &tree) {
+        if (!tree.root) return;
+
+        std::vector<T> values;
+        std::vector<std::pair<Node<T> *, bool>> stack{{tree.root.get(), false}};
+        while (!stack.empty()) {
+            auto [node, done] = stack.back();
+            stack.pop_back();
+            if (done) {
+                auto &range = ranges[node];
+                range.second = nodes.size();
+                continue;
+            }
+            ranges.emplace(node, std::make_pair(nodes.size(), nodes.size()));
+            nodes.push_back(node);
+            values.push_back(node->data);
+            stack.emplace_back(node, true);
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) stack.emplace_back(it->get(), false);
+            }
+        }
+        segments = SegmentTree<T>(values);
+        weights = FenwickTree<T>(values);
+    }
+
+    /**
+     * @brief Summarizes the subtree rooted at a node, the node included.
+     *
+     * @throws std::invalid_argument If the node is not part of the indexed tree.
+     */
+    RangeSummary<T> subtree(const Node<T> *node) const {
+        auto range = range_of(node);
+        return segments.query(range.first, range.second);
+    }
+
+    T subtree_sum(const Node<T> *node) const { return subtree(node).sum; }
+
+    T subtree_min(const Node<T> *node) const { return subtree(node).min; }
+
+    T subtree_max(const Node<T> *node) const { return subtree(node).max; }
+
+    size_t subtree_count(const Node<T> *node) const {
+        auto range = range_of(node);
+        return range.second - range.first;
+    }
+
+    /**
+     * @brief Changes a node's value and updates the index in O(log n).
+     *
+     * @throws std::invalid_argument If the node is not part of the indexed tree.
+     */
+    void set_data(Node<T> *node, const T &value) {
+        auto range = range_of(node);
+        weights.add(range.first, value - node->data);
+        node->set_data(value);
+        segments.update(range.first, value);
+    }
+
+    /**
+     * @brief Draws @p k nodes with replacement, each with probability proportional to its value.
+     *
+     * Every draw is a prefix search over the indexed values, O(log n). Values must be non-negative.
+     *
+     * @param k The number of nodes to draw.
+     * @param rng A uniform random bit generator.
+     *
+     * @throws std::logic_error If the values do not sum to a positive weight.
+     */
+    template<typename Rng>
+    std::vector<Node<T> *> sample_weighted(size_t k, Rng &rng) const {
+        std::vector<Node<T> *> picks;
+        if (k == 0) return picks;
+
+        T total = weights.total();
+        if (!(T{} < total)) throw std::logic_error("Total weight must be positive.");
+        using Distribution = std::conditional_t<std::is_integral_v<T>,
+                std::uniform_int_distribution<T>, std::uniform_real_distribution<T>>;
+        Distribution target(T{}, std::is_integral_v<T> ? total - 1 : total);
+
+        picks.reserve(k);
+        for (size_t i = 0; i < k; ++i) {
+            size_t position = weights.upper_bound(target(rng));
+            picks.push_back(nodes[std::min(position, nodes.size() - 1)]);
+        }
+        return picks;
+    }
+
+private:
+    std::vector<Node<T> *> nodes; ///< Nodes in pre-order.
+    std::unordered_map<const Node<T> *, std::pair<size_t, size_t>> ranges; ///< Pre-order id range of each subtree.
+    SegmentTree<T> segments;
+    FenwickTree<T> weights; ///< Prefix sums of the values in pre-order, for weighted sampling.
+
+    std::pair<size_t, size_t> range_of(const Node<T> *node) const {
+        auto found = ranges.find(node);
+        if (found == ranges.end()) throw std::invalid_argument("Node is not part of the indexed tree.");
+        return found->second;
+    }
+};
+
+#endif // SUBTREE_INDEX_HPP
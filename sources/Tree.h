@@ -1,13 +1,53 @@
 #ifndef TREE_HPP
 #define TREE_HPP
 
+#include "BloomFilter.h"
+#include "FlatTree.h"
+#include "FrozenTree.h"
 #include "Node.h"
+#include "NodeArena.h"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <functional>
 #include <iostream>
 #include <stdexcept>
 #include <queue>
+#include <random>
+#include <span>
 #include <stack>
+#include <thread>
 #include <vector>
 #include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Satisfied by value types that std::hash can hash.
+ */
+template<typename U>
+concept Hashable = requires(const U &value) {
+    { std::hash<U>{}(value) } -> std::convertible_to<size_t>;
+};
+
+/**
+ * @brief Memory orders that Tree::compact() can rewrite node storage into.
+ */
+enum class Layout {
+    Preorder,   ///< Parents before children, subtrees contiguous.
+    BFS,        ///< Level by level, left to right.
+    VanEmdeBoas ///< Recursive top/bottom split; cache-oblivious for root-to-leaf walks.
+};
+
+/**
+ * @brief What Tree::remove_node() does with the children of the removed node.
+ */
+enum class RemovePolicy {
+    Promote, ///< The children take the node's place under its parent, in order.
+    Reject   ///< Only leaves may be removed; a node with children throws.
+};
 
 /**
  * @brief A generic k-ary tree class.
@@ -29,12 +69,184 @@ public:
      */
     Tree() : root(nullptr) {}
 
+    /**
+     * @brief Copy constructor; makes a deep copy of @p other.
+     *
+     * All nodes are cloned without recursion, in pre-order, together with every
+     * tracked augmentation; a small tree lands in one freshly reserved arena block.
+     * Trees above a size threshold are cloned subtree by subtree on several threads.
+     *
+     * @param other The tree to copy.
+     */
+    Tree(const Tree &other) : Tree(other.clone(other.node_count < parallel_clone_threshold ? 1U : 0U)) {}
+
+    /**
+     * @brief Move constructor; takes over the nodes of @p other and leaves it empty.
+     */
+    Tree(Tree &&other) noexcept
+            : root(std::move(other.root)), arena(std::move(other.arena)),
+              node_count(std::exchange(other.node_count, 0)), level_counts(std::move(other.level_counts)),
+              tracking_sizes(other.tracking_sizes), tracking_bounds(other.tracking_bounds),
+              filter_stride(other.filter_stride), filter_bits_per_item(other.filter_bits_per_item),
+              filter_budget(other.filter_budget), filter_memory(std::exchange(other.filter_memory, 0)),
+              filters(std::move(other.filters)) {
+        other.level_counts.clear();
+        other.filters.clear();
+    }
+
+    /**
+     * @brief Returns a deep copy made with an explicit number of threads.
+     *
+     * @param threads The number of cloning threads; 0 uses the hardware concurrency.
+     */
+    Tree clone(unsigned threads) const {
+        Tree copy;
+        copy.node_count = node_count;
+        copy.level_counts = level_counts;
+        copy.tracking_sizes = tracking_sizes;
+        copy.tracking_bounds = tracking_bounds;
+        copy.filter_stride = filter_stride;
+        copy.filter_bits_per_item = filter_bits_per_item;
+        copy.filter_budget = filter_budget;
+        copy.copy_nodes(*this, threads);
+        return copy;
+    }
+
+    Tree &operator=(const Tree &other) {
+        if (this != &other) *this = Tree(other);
+        return *this;
+    }
+
+    Tree &operator=(Tree &&other) noexcept {
+        if (this == &other) return *this;
+        delete_tree(std::move(root));
+        root = std::move(other.root);
+        arena = std::move(other.arena);
+        node_count = std::exchange(other.node_count, 0);
+        level_counts = std::move(other.level_counts);
+        other.level_counts.clear();
+        tracking_sizes = other.tracking_sizes;
+        tracking_bounds = other.tracking_bounds;
+        filter_stride = other.filter_stride;
+        filter_bits_per_item = other.filter_bits_per_item;
+        filter_budget = other.filter_budget;
+        filter_memory = std::exchange(other.filter_memory, 0);
+        filters = std::move(other.filters);
+        other.filters.clear();
+        return *this;
+    }
+
     /**
      * @brief Destructor.
      * Deletes the tree by deallocating all nodes.
      */
     ~Tree() {
-        delete_tree(root);
+        delete_tree(std::move(root));
+    }
+
+    /**
+     * @brief Builds a tree from a parent array in O(n).
+     *
+     * Node i gets value @p values[i] and hangs below node @p parents[i]; exactly one
+     * entry must be negative, marking the root. Entries may come in any order and
+     * children keep the order of their indices. Nodes are allocated in pre-order
+     * from one reserved arena block.
+     *
+     * @param values The value of every node.
+     * @param parents The parent index of every node, or a negative number for the root.
+     *
+     * @throws std::invalid_argument If the arrays differ in length, there is not exactly one root,
+     *                               an index is out of range, a node has more than N children,
+     *                               or the input contains a cycle.
+     */
+    static Tree from_parent_array(std::span<const T> values, std::span<const std::ptrdiff_t> parents) {
+        if (values.size() != parents.size()) {
+            throw std::invalid_argument("Need exactly one parent entry per value.");
+        }
+        Tree tree;
+        tree.build_from_parents(values, parents);
+        return tree;
+    }
+
+    /**
+     * @brief Builds a tree from (child, parent) index pairs in O(n).
+     *
+     * Node i gets value @p values[i]; the one node that never appears as a child
+     * becomes the root. Edges may come in any order and children keep the order of
+     * their indices. Above a million edges the edges are distributed over several threads.
+     *
+     * @param values The value of every node.
+     * @param edges One (child, parent) pair for every node except the root.
+     * @param threads The number of threads for large inputs; 0 uses the hardware concurrency.
+     *
+     * @throws std::invalid_argument If an index is out of range, a node has two parents,
+     *                               or the result would not be a tree with at most N children per node.
+     */
+    static Tree from_edges(std::span<const T> values, std::span<const std::pair<size_t, size_t>> edges,
+                           unsigned threads = 0) {
+        const size_t n = values.size();
+        std::vector<std::ptrdiff_t> parents(n, -1);
+        std::atomic<int> failure{0};
+        auto scatter = [&](size_t begin, size_t end) {
+            for (size_t e = begin; e < end && failure.load(std::memory_order_relaxed) == 0; ++e) {
+                auto [child, parent] = edges[e];
+                if (child >= n || parent >= n) {
+                    failure.store(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::ptrdiff_t expected = -1;
+                if (!std::atomic_ref<std::ptrdiff_t>(parents[child]).compare_exchange_strong(
+                        expected, static_cast<std::ptrdiff_t>(parent), std::memory_order_relaxed)) {
+                    failure.store(2, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        };
+
+        if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+        if (edges.size() <= parallel_build_threshold) threads = 1;
+        const size_t chunk = (edges.size() + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back(scatter, std::min(edges.size(), i * chunk), std::min(edges.size(), (i + 1) * chunk));
+        }
+        scatter(0, std::min(edges.size(), chunk));
+        for (auto &thread : workers) thread.join();
+
+        if (failure == 1) throw std::invalid_argument("Edge refers to a node outside the values.");
+        if (failure == 2) throw std::invalid_argument("Node has more than one parent.");
+        return from_parent_array(values, parents);
+    }
+
+    /**
+     * @brief Builds a complete tree from values in level order, in O(n).
+     *
+     * Node i becomes the parent of nodes i*N+1 ... i*N+N, the layout ImplicitTree
+     * uses, so every level is full except possibly the last, which fills from the
+     * left. Nodes are allocated level by level from one reserved arena block.
+     *
+     * @param values The node values, root first, then each level left to right.
+     */
+    static Tree from_level_order(std::span<const T> values) {
+        Tree tree;
+        if (values.empty()) return tree;
+
+        const size_t n = values.size();
+        tree.reserve_nodes(n);
+        std::vector<Node<T> *> made;
+        made.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            auto node = tree.make_node(values[i]);
+            const size_t first = i * static_cast<size_t>(N) + 1;
+            if (first < n) node->children.reserve(std::min(static_cast<size_t>(N), n - first));
+            made.push_back(node.get());
+            if (i == 0) {
+                tree.plant_root(std::move(node));
+            } else {
+                tree.link_child(made[(i - 1) / static_cast<size_t>(N)], node);
+            }
+        }
+        return tree;
     }
 
     /**
@@ -43,7 +255,7 @@ public:
      * @param root_node The node to be added as the root.
      */
     void add_root(const Node<T> &root_node) {
-        root = std::make_shared<Node<T>>(root_node.data);
+        plant_root(make_node(root_node.data));
     }
 
     /**
@@ -61,210 +273,1008 @@ public:
             throw std::runtime_error("Root node is not initialized.");
         }
 
-        auto parent = find_node(root, parent_node.data);
+        auto *parent = find(parent_node.data);
         if (!parent) {
             throw std::runtime_error("Parent node not found.");
         }
 
-        sub_node.resize_children(N);
-
-        auto new_node = std::make_shared<Node<T>>(sub_node.data);
-        new_node->children = std::move(sub_node.children);
+        auto new_node = make_node(sub_node.data);
 
         if (parent->numOfChildren == N) {
             throw std::runtime_error("Parent node has reached maximum number of children.");
         } else {
-            parent->children.push_back(new_node);
-            parent->numOfChildren++;
+            link_child(parent, new_node);
         }
     }
 
     /**
-     * @brief Prints the tree structure.
+     * @brief Adds a child with the given value directly under a known parent.
      *
-     * This function prints the tree structure starting from the root.
-     * Each level of the tree is indented to visually represent the tree hierarchy.
+     * Unlike add_sub_node() this does not search for the parent, so it runs in O(1).
+     *
+     * @param parent The node to add the child to.
+     * @param value The value of the new child.
+     *
+     * @return Node<T>* The newly created node.
+     *
+     * @throws std::invalid_argument If the parent is null.
+     * @throws std::runtime_error If the parent node has reached the maximum number of children.
      */
-    void print() const {
-        printHelper(root, 0);
-    }
-    /**
-      * @brief Returns a pre-order iterator starting at the root of the tree.
-      *
-      * @return PreOrderIterator An iterator for pre-order traversal.
-      */
-    class PreOrderIterator {
-    public:
-        explicit PreOrderIterator(std::shared_ptr<Node<T>> root) {
-            if (root) {
-                stack.push(root);
-            }
+    Node<T> *add_child(Node<T> *parent, const T &value) {
+        if (!parent) {
+            throw std::invalid_argument("Parent node is null.");
         }
-
-        [[nodiscard]] bool has_next() const {
-            return !stack.empty();
+        if (parent->numOfChildren == N) {
+            throw std::runtime_error("Parent node has reached maximum number of children.");
         }
 
-        T next() {
-            if (!has_next()) throw std::out_of_range("No more elements");
-
-            auto node = stack.top();
-            stack.pop();
-
-            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
-                if (*it) stack.push(*it);
-            }
+        auto new_node = make_node(value);
+        link_child(parent, new_node);
+        return new_node.get();
+    }
 
-            return node->data;
-        }
+    /**
+     * @brief Removes a node together with everything below it.
+     *
+     * The subtree is unlinked from its parent in O(N) and the remaining siblings keep
+     * their order. Its nodes are then released without recursion and their storage
+     * goes back to the arena's free lists, where later insertions pick it up again.
+     * Size, height and tracked sizes and bounds are updated in O(subtree + depth).
+     * Membership filters of the ancestors keep the removed values, which only costs
+     * false positives. Pointers to removed nodes and indexes built over the tree are invalidated.
+     *
+     * @param node The root of the subtree to remove; removing the root empties the tree.
+     *
+     * @throws std::invalid_argument If the node is null or not part of this tree.
+     */
+    void remove_subtree(Node<T> *node) {
+        require_member(node);
+        std::vector<Node<T> *> removed;
+        delete_tree(detach(node, removed));
+    }
 
-    private:
-        std::stack<std::shared_ptr<Node<T>>> stack;
-    };
-/**
-     * @brief Returns a post-order iterator starting at the root of the tree.
+    /**
+     * @brief Moves a subtree under a new parent within this tree.
      *
-     * @return PostOrderIterator An iterator for post-order traversal.
+     * The subtree is relinked as the new parent's last child; no node is copied or
+     * reallocated. Depths inside the subtree are re-stamped and level counts,
+     * tracked sizes, bounds and membership filters are updated for the moved nodes
+     * and the old and new ancestors, so a move costs O(depth + subtree size).
+     *
+     * @param subtree The root of the subtree to move.
+     * @param new_parent The node to attach it to.
+     *
+     * @throws std::invalid_argument If a node is null or not in this tree, the subtree is the root,
+     *                               or the new parent lies inside the subtree.
+     * @throws std::runtime_error If the new parent has reached the maximum number of children.
      */
-    class PostOrderIterator {
-    public:
-        explicit PostOrderIterator(std::shared_ptr<Node<T>> root) {
-            if (root) {
-                add_nodes(root);
-            }
+    void splice(Node<T> *subtree, Node<T> *new_parent) {
+        require_member(subtree);
+        require_member(new_parent);
+        if (subtree == root.get()) {
+            throw std::invalid_argument("Cannot move the root.");
         }
-
-        [[nodiscard]] bool has_next() const {
-            return !queue.empty();
+        for (const Node<T> *up = new_parent; up; up = up->parent) {
+            if (up == subtree) throw std::invalid_argument("New parent lies inside the subtree.");
         }
-
-        T next() {
-            if (!has_next()) throw std::out_of_range("No more elements");
-
-            auto node = queue.front();
-            queue.pop();
-            return node->data;
+        if (new_parent->numOfChildren == N) {
+            throw std::runtime_error("Parent node has reached maximum number of children.");
         }
 
-    private:
-        std::queue<std::shared_ptr<Node<T>>> queue;
-
-        void add_nodes(const std::shared_ptr<Node<T>> &node) {
-            if (!node) return;
+        std::vector<Node<T> *> moved;
+        auto detached = detach(subtree, moved);
+        attach(new_parent, std::move(detached), moved);
+    }
 
-            for (const auto &child : node->children) {
-                add_nodes(child);
-            }
-            queue.push(node);
-        }
-    };
     /**
-        * @brief Returns an in-order iterator starting at the root of the tree.
-        *
-        * @return InOrderIterator An iterator for in-order traversal.
-        */
-    class InOrderIterator {
-    public:
-        explicit InOrderIterator(std::shared_ptr<Node<T>> root) {
-            add_nodes(root);
+     * @brief Moves a subtree out of another tree and under a node of this one.
+     *
+     * Works like splice(): the nodes themselves are relinked, not copied, and keep
+     * the storage of the tree they were created in. Both trees' bookkeeping is
+     * updated; grafting the other tree's root leaves it empty.
+     *
+     * The grafted nodes stay in @p other's node arena, which is not thread-safe,
+     * so freeing them here and allocating there share one free list. Afterwards
+     * the two trees must not be modified on different threads at the same time,
+     * until compact() has moved this tree's nodes into its own arena.
+     *
+     * @param other The tree to take the subtree from.
+     * @param subtree The root of the subtree to move, a node of @p other.
+     * @param new_parent The node of this tree to attach it to.
+     *
+     * @throws std::invalid_argument If a node is null or not in its tree.
+     * @throws std::runtime_error If the new parent has reached the maximum number of children.
+     */
+    void graft(Tree &other, Node<T> *subtree, Node<T> *new_parent) {
+        if (&other == this) {
+            splice(subtree, new_parent);
+            return;
         }
-
-        [[nodiscard]] bool has_next() const {
-            return !nodes.empty();
+        other.require_member(subtree);
+        require_member(new_parent);
+        if (new_parent->numOfChildren == N) {
+            throw std::runtime_error("Parent node has reached maximum number of children.");
         }
 
-        T next() {
-            if (!has_next()) throw std::out_of_range("No more elements");
+        std::vector<Node<T> *> moved;
+        auto detached = other.detach(subtree, moved);
+        attach(new_parent, std::move(detached), moved);
+    }
 
-            auto node = nodes.front();
-            nodes.erase(nodes.begin());
-            return node->data;
+    /**
+     * @brief Removes a single node.
+     *
+     * With RemovePolicy::Promote the node's children take its slot in the parent, in
+     * their current order, and their subtrees move up one level; null child slots
+     * are dropped. A removed root
+     * can only be replaced by a single child. Promoting re-stamps the depths of the
+     * moved subtrees and rebuilds membership filters, if any.
+     *
+     * @param node The node to remove.
+     * @param policy What to do with the node's children.
+     *
+     * @throws std::invalid_argument If the node is null or not part of this tree.
+     * @throws std::runtime_error If the policy is Reject and the node has children.
+     * @throws std::runtime_error If the children do not fit into the parent or, for the root, there is more than one.
+     */
+    void remove_node(Node<T> *node, RemovePolicy policy) {
+        require_member(node);
+        if (node->numOfChildren == 0) {
+            remove_subtree(node);
+            return;
+        }
+        if (policy == RemovePolicy::Reject) {
+            throw std::runtime_error("Node has children.");
         }
 
-    private:
-        std::vector<std::shared_ptr<Node<T>>> nodes;
+        Node<T> *parent = node->parent;
+        if (!parent && node->numOfChildren > 1) {
+            throw std::runtime_error("Cannot promote more than one child to the root.");
+        }
+        if (parent && parent->numOfChildren - 1 + node->numOfChildren > N) {
+            throw std::runtime_error("Parent node has no room for the promoted children.");
+        }
 
-        void add_nodes(const std::shared_ptr<Node<T>> &node) {
-            if (!node) return;
+        std::vector<Node<T> *> moved;
+        NoPrune prune;
+        for (const auto &child : node->children) {
+            search(child.get(), [&](Node<T> *below) {
+                moved.push_back(below);
+                return false;
+            }, prune);
+        }
+        for (auto *below : moved) {
+            --level_counts[static_cast<size_t>(below->depth)];
+            --below->depth;
+            ++level_counts[static_cast<size_t>(below->depth)];
+        }
+        --level_counts[static_cast<size_t>(node->depth)];
+        --node_count;
+        drop_filter(node);
+        trim_levels();
 
-            if (!node->children.empty()) {
-                add_nodes(node->children[0]);
+        auto orphans = std::move(node->children);
+        node->children.clear();
+        node->links = {};
+        std::erase(orphans, nullptr);
+        if (!parent) {
+            auto detached = std::move(root);
+            if (!orphans.empty()) {
+                root = orphans.front();
+                root->parent = nullptr;
             }
+        } else {
+            auto slot = child_slot(node);
+            auto detached = std::move(*slot);
+            parent->children.insert(parent->children.erase(slot), orphans.begin(), orphans.end());
+            for (const auto &child : orphans) child->parent = parent;
+            parent->numOfChildren += static_cast<int>(orphans.size()) - 1;
+            sync_links(parent);
 
-            nodes.push_back(node);
-
-            if (node->children.size() > 1) {
-                for (size_t i = 1; i < node->children.size(); ++i) {
-                    add_nodes(node->children[i]);
-                }
+            if (tracking_sizes) {
+                for (Node<T> *up = parent; up; up = up->parent) --up->subtree_size;
             }
+            refresh_bounds_upwards(parent);
         }
-    };
-/**
-     * @brief Returns a BFS iterator starting at the root of the tree.
+        if constexpr (Hashable<T>) {
+            if (filter_stride > 0) rebuild_filters();
+        }
+    }
+
+    /**
+     * @brief Rewrites node storage so that nodes sit in memory in the given order.
      *
-     * @return BFSIterator An iterator for breadth-first search traversal.
+     * All nodes are reallocated from a fresh arena in @p layout order and the old
+     * storage is released. Traversals that follow the same order then walk memory
+     * sequentially. Pointers to existing nodes are invalidated.
+     *
+     * @param layout The order to place nodes in.
      */
-    class BFSIterator {
-    public:
-        explicit BFSIterator(std::shared_ptr<Node<T>> root) {
-            if (root) {
-                queue.push(root);
-            }
-        }
+    void compact(Layout layout) {
+        if (!root) return;
 
-        [[nodiscard]] bool has_next() const {
-            return !queue.empty();
+        std::vector<Node<T> *> order;
+        if (layout == Layout::Preorder) {
+            preorder_layout(order);
+        } else if (layout == Layout::BFS) {
+            bfs_layout(order);
+        } else {
+            veb_layout(root.get(), tree_levels(), order);
         }
 
-        T next() {
-            if (!has_next()) throw std::out_of_range("No more elements");
-
-            auto node = queue.front();
-            queue.pop();
+        arena = std::make_shared<NodeArena>();
+        std::unordered_map<const Node<T> *, std::shared_ptr<Node<T>>> moved;
+        moved.reserve(order.size());
+        for (auto *node : order) {
+            moved.emplace(node, make_node(std::move(node->data)));
+        }
 
-            for (auto &child : node->children) {
-                if (child) queue.push(child);
+        for (auto *node : order) {
+            auto &copy = moved[node];
+            copy->numOfChildren = node->numOfChildren;
+            copy->children.reserve(node->children.size());
+            for (const auto &child : node->children) {
+                copy->children.push_back(child ? moved[child.get()] : nullptr);
             }
+            copy->parent = node->parent ? moved[node->parent].get() : nullptr;
+            copy->depth = node->depth;
+            copy->subtree_size = node->subtree_size;
+            copy->bounds = node->bounds;
+            for (size_t side = 0; side < 2; ++side) {
+                copy->links[side] = node->links[side] ? moved[node->links[side]].get() : nullptr;
+            }
+        }
 
-            return node->data;
+        auto old_root = std::move(root);
+        root = moved[old_root.get()];
+        delete_tree(std::move(old_root));
+        if constexpr (Hashable<T>) {
+            if (filter_stride > 0) rebuild_filters();
         }
+    }
 
-    private:
-        std::queue<std::shared_ptr<Node<T>>> queue;
-    };
-/**
-     * @brief Returns a DFS iterator starting at the root of the tree.
+    /**
+     * @brief Returns the number of nodes in the tree, in O(1).
+     */
+    [[nodiscard]] size_t size() const {
+        return node_count;
+    }
+
+    /**
+     * @brief Returns the number of edges on the longest root-to-leaf path, in O(1).
      *
-     * @return DFSIterator An iterator for depth-first search traversal.
+     * @return int The height, 0 for a single root and -1 for an empty tree.
      */
-    class DFSIterator {
-    public:
-        explicit DFSIterator(std::shared_ptr<Node<T>> root) {
-            if (root) {
-                stack.push(root);
+    [[nodiscard]] int height() const {
+        return static_cast<int>(level_counts.size()) - 1;
+    }
+
+    /**
+     * @brief Starts maintaining Node::subtree_size for every node.
+     *
+     * Computes all sizes once in O(n); afterwards each insertion updates the sizes
+     * along its path to the root in O(depth).
+     */
+    void track_subtree_sizes() {
+        if (tracking_sizes) return;
+        tracking_sizes = true;
+        if (!root) return;
+
+        std::vector<Node<T> *> order;
+        preorder_layout(order);
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            Node<T> *node = *it;
+            node->subtree_size = 1;
+            for (const auto &child : node->children) {
+                if (child) node->subtree_size += child->subtree_size;
             }
         }
+    }
 
-        [[nodiscard]] bool has_next() const {
-            return !stack.empty();
-        }
+    /**
+     * @brief Starts maintaining Node::bounds, the value range of every subtree.
+     *
+     * Computes all bounds once in O(n); afterwards insertions and Tree::set_data()
+     * update them along the path to the root, stopping early once a bound is unchanged.
+     * Only available for arithmetic value types.
+     */
+    void track_value_bounds() requires std::is_arithmetic_v<T> {
+        if (tracking_bounds) return;
+        tracking_bounds = true;
+        if (!root) return;
 
-        T next() {
-            if (!has_next()) throw std::out_of_range("No more elements");
+        std::vector<Node<T> *> order;
+        preorder_layout(order);
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            refresh_bounds(*it);
+        }
+    }
+
+    /**
+     * @brief Starts maintaining Bloom filters that let value searches skip whole subtrees.
+     *
+     * Every node whose depth is a multiple of @p level_stride gets a filter of the
+     * values in its subtree. find() and add_sub_node() skip any subtree whose filter
+     * rules the value out. Insertions and Tree::set_data() add to the filters of the
+     * node's ancestors; a filter that outgrows its capacity is rebuilt twice as large.
+     *
+     * A memory budget is a hard bound on membership_memory(). To fit it, the bits
+     * per item are lowered down to one and then the stride is doubled; once the
+     * budget is used up, new filters are not created and full ones are not grown,
+     * which only makes searches prune less.
+     *
+     * @param level_stride Distance in levels between filtered nodes.
+     * @param false_positive_rate Target false-positive rate of each filter.
+     * @param memory_budget Upper bound in bytes for all filters together; 0 for no bound.
+     *
+     * @throws std::invalid_argument If the stride is not positive or the rate is not in (0, 1).
+     */
+    void track_membership(int level_stride = 4, double false_positive_rate = 0.01, size_t memory_budget = 0)
+    requires Hashable<T> {
+        if (level_stride <= 0) throw std::invalid_argument("Level stride must be positive.");
+        if (!(false_positive_rate > 0.0 && false_positive_rate < 1.0)) {
+            throw std::invalid_argument("False-positive rate must be between 0 and 1.");
+        }
+        filter_stride = level_stride;
+        filter_bits_per_item = BloomFilter<T>::bits_per_item_for(false_positive_rate);
+        filter_budget = memory_budget;
+        rebuild_filters();
+    }
+
+    /**
+     * @brief Returns the number of bytes currently held by membership filters.
+     */
+    [[nodiscard]] size_t membership_memory() const {
+        return filter_memory;
+    }
+
+    /**
+     * @brief Changes a node's value, keeping any tracked augmentation current.
+     *
+     * @param node The node to change.
+     * @param value The new value.
+     *
+     * @throws std::invalid_argument If the node is null.
+     */
+    void set_data(Node<T> *node, const T &value) {
+        if (!node) throw std::invalid_argument("Node is null.");
+        node->set_data(value);
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (tracking_bounds) {
+                for (Node<T> *up = node; up && refresh_bounds(up); up = up->parent) {}
+            }
+        }
+        if constexpr (Hashable<T>) {
+            if (filter_stride > 0) add_to_filters(node, node->data);
+        }
+    }
+
+    /**
+     * @brief Collects every node, in pre-order, whose value lies in [lo, hi].
+     *
+     * Subtrees whose tracked bounds cannot intersect the range are skipped whole,
+     * so clustered data only visits the nodes near matches. Requires track_value_bounds().
+     *
+     * @throws std::logic_error If value bounds are not being tracked.
+     */
+    std::vector<Node<T> *> range_query(const T &lo, const T &hi) const requires std::is_arithmetic_v<T> {
+        if (!tracking_bounds) throw std::logic_error("Value bounds are not tracked.");
+        return find_all_if([&](const T &value) { return !(value < lo) && !(hi < value); },
+                           [&](const Node<T> &node) { return node.bounds.max < lo || hi < node.bounds.min; });
+    }
+
+    /**
+     * @brief Returns the node at the given position in pre-order, using subtree sizes.
+     *
+     * Runs in O(depth * N) by skipping whole subtrees. Requires track_subtree_sizes().
+     *
+     * @param rank The zero-based pre-order position.
+     *
+     * @throws std::logic_error If subtree sizes are not being tracked.
+     * @throws std::out_of_range If rank is not smaller than size().
+     */
+    Node<T> *node_at(size_t rank) const {
+        if (!tracking_sizes) throw std::logic_error("Subtree sizes are not tracked.");
+        if (rank >= node_count) throw std::out_of_range("Rank outside the tree");
+
+        Node<T> *node = root.get();
+        while (rank > 0) {
+            --rank;
+            for (const auto &child : node->children) {
+                if (!child) continue;
+                if (rank < child->subtree_size) {
+                    node = child.get();
+                    break;
+                }
+                rank -= child->subtree_size;
+            }
+        }
+        return node;
+    }
+
+    /**
+     * @brief Draws @p k nodes uniformly at random, with replacement.
+     *
+     * Each draw picks a random pre-order rank and resolves it with node_at(), so a
+     * call costs O(k * depth * N) and never materializes the tree. Subtree size
+     * tracking is switched on by the first call.
+     *
+     * @param k The number of nodes to draw.
+     * @param rng A uniform random bit generator.
+     *
+     * @throws std::out_of_range If k is positive and the tree is empty.
+     */
+    template<typename Rng>
+    std::vector<Node<T> *> sample(size_t k, Rng &rng) {
+        std::vector<Node<T> *> picks;
+        if (k == 0) return picks;
+        if (!root) throw std::out_of_range("Cannot sample from an empty tree");
+
+        track_subtree_sizes();
+        std::uniform_int_distribution<size_t> rank(0, node_count - 1);
+        picks.reserve(k);
+        for (size_t i = 0; i < k; ++i) picks.push_back(node_at(rank(rng)));
+        return picks;
+    }
+
+    /**
+     * @brief Prune callback that never skips anything.
+     */
+    struct NoPrune {
+        bool operator()(const Node<T> &) const { return false; }
+    };
+
+    /**
+     * @brief Finds the first node, in pre-order, whose value satisfies a predicate.
+     *
+     * The search stops at the first hit.
+     *
+     * @param pred Called with each visited value.
+     * @param prune Called with each node before visiting it; returning true skips the
+     *              node and its whole subtree.
+     *
+     * @return Node<T>* The first matching node, or nullptr.
+     */
+    template<typename Pred, typename Prune = NoPrune>
+    Node<T> *find_if(Pred pred, Prune prune = Prune{}) const {
+        Node<T> *hit = nullptr;
+        search(root.get(), [&](Node<T> *node) {
+            if (!pred(node->data)) return false;
+            hit = node;
+            return true;
+        }, prune);
+        return hit;
+    }
+
+    /**
+     * @brief Collects every node, in pre-order, whose value satisfies a predicate.
+     *
+     * @param pred Called with each visited value.
+     * @param prune Called with each node before visiting it; returning true skips the
+     *              node and its whole subtree.
+     */
+    template<typename Pred, typename Prune = NoPrune>
+    std::vector<Node<T> *> find_all_if(Pred pred, Prune prune = Prune{}) const {
+        std::vector<Node<T> *> hits;
+        search(root.get(), [&](Node<T> *node) {
+            if (pred(node->data)) hits.push_back(node);
+            return false;
+        }, prune);
+        return hits;
+    }
+
+    /**
+     * @brief Finds some node whose value satisfies a predicate, searching subtrees in parallel.
+     *
+     * The top of the tree is searched on the calling thread until there are enough
+     * subtrees to share out; worker threads then take subtrees one at a time and all
+     * of them stop as soon as any finds a match. The hit is not necessarily the first
+     * one in pre-order. @p pred and @p prune must be safe to call concurrently.
+     *
+     * @param pred Called with each visited value.
+     * @param prune Called with each node before visiting it; returning true skips the
+     *              node and its whole subtree.
+     * @param threads The number of worker threads; 0 uses the hardware concurrency.
+     *
+     * @return Node<T>* A matching node, or nullptr.
+     */
+    template<typename Pred, typename Prune = NoPrune>
+    Node<T> *find_if_parallel(Pred pred, Prune prune = Prune{}, unsigned threads = 0) const {
+        if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+
+        std::vector<Node<T> *> frontier;
+        if (root && !prune(*root)) frontier.push_back(root.get());
+        while (!frontier.empty() && frontier.size() < 4 * threads) {
+            std::vector<Node<T> *> next;
+            for (auto *node : frontier) {
+                if (pred(node->data)) return node;
+                for (const auto &child : node->children) {
+                    if (child && !prune(*child)) next.push_back(child.get());
+                }
+            }
+            frontier = std::move(next);
+        }
+
+        std::atomic<Node<T> *> hit{nullptr};
+        std::atomic<size_t> next_subtree{0};
+        auto worker = [&] {
+            for (size_t i = next_subtree++; i < frontier.size() && !hit.load(std::memory_order_relaxed); i = next_subtree++) {
+                search(frontier[i], [&](Node<T> *node) {
+                    if (hit.load(std::memory_order_relaxed)) return true;
+                    if (!pred(node->data)) return false;
+                    Node<T> *none = nullptr;
+                    hit.compare_exchange_strong(none, node);
+                    return true;
+                }, prune);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads && i < frontier.size(); ++i) workers.emplace_back(worker);
+        worker();
+        for (auto &thread : workers) thread.join();
+        return hit.load();
+    }
+
+    /**
+     * @brief Resolves a batch of values to nodes in a single traversal.
+     *
+     * Each value maps to the first node in pre-order holding it, exactly like find().
+     * Hashable values are matched through a hash table, O(n + m); other values need
+     * operator< and are matched by binary search, O((n + m) log m). The walk stops
+     * as soon as every value has been resolved.
+     *
+     * @param values The values to look up.
+     *
+     * @return std::vector<Node<T> *> The node for each value in input order, nullptr where absent.
+     */
+    std::vector<Node<T> *> find_many(std::span<const T> values) const {
+        std::vector<Node<T> *> hits(values.size(), nullptr);
+        NoPrune prune;
+
+        if constexpr (Hashable<T>) {
+            std::unordered_map<T, std::vector<size_t>> pending;
+            for (size_t i = 0; i < values.size(); ++i) pending[values[i]].push_back(i);
+            search(root.get(), [&](Node<T> *node) {
+                auto found = pending.find(node->data);
+                if (found == pending.end()) return false;
+                for (size_t i : found->second) hits[i] = node;
+                pending.erase(found);
+                return pending.empty();
+            }, prune);
+        } else {
+            std::vector<size_t> order(values.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            auto less = [&](size_t a, size_t b) { return values[a] < values[b]; };
+            std::sort(order.begin(), order.end(), less);
+            size_t unresolved = values.size();
+            search(root.get(), [&](Node<T> *node) {
+                auto first = std::lower_bound(order.begin(), order.end(), node->data,
+                                              [&](size_t i, const T &value) { return values[i] < value; });
+                for (auto it = first; it != order.end() && !(node->data < values[*it]); ++it) {
+                    if (hits[*it]) break;
+                    hits[*it] = node;
+                    --unresolved;
+                }
+                return unresolved == 0;
+            }, prune);
+        }
+        return hits;
+    }
+
+    /**
+     * @brief Finds the first node, in pre-order, holding the given value.
+     *
+     * @param value The value to search for.
+     *
+     * @return Node<T>* The node, or nullptr if no node holds the value.
+     */
+    Node<T> *find(const T &value) const {
+        if constexpr (Hashable<T>) {
+            if (filter_stride > 0) {
+                auto hash = BloomFilter<T>::hash(value);
+                return find_if([&](const T &data) { return data == value; }, [&](const Node<T> &node) {
+                    if (node.depth % filter_stride != 0) return false;
+                    auto filter = filters.find(&node);
+                    return filter != filters.end() && !filter->second.might_contain(hash);
+                });
+            }
+        }
+        return find_node(root, value).get();
+    }
+
+    /**
+     * @brief Returns the number of edges between a node and the root, in O(1).
+     *
+     * @param node The node to measure.
+     *
+     * @throws std::invalid_argument If the node is null.
+     */
+    int depth(const Node<T> *node) const {
+        if (!node) throw std::invalid_argument("Node is null.");
+        return node->depth;
+    }
+
+    /**
+     * @brief Returns the ancestors of a node, nearest first, in O(depth).
+     *
+     * @param node The node whose ancestors to collect. The node itself is not included.
+     *
+     * @throws std::invalid_argument If the node is null.
+     */
+    std::vector<Node<T> *> ancestors(const Node<T> *node) const {
+        if (!node) throw std::invalid_argument("Node is null.");
+        std::vector<Node<T> *> path;
+        for (Node<T> *up = node->parent; up; up = up->parent) path.push_back(up);
+        return path;
+    }
+
+    /**
+     * @brief Returns the path from a node up to the root, both included, in O(depth).
+     *
+     * @param node The node to start from.
+     *
+     * @throws std::invalid_argument If the node is null.
+     */
+    std::vector<Node<T> *> path_to_root(Node<T> *node) const {
+        std::vector<Node<T> *> path = ancestors(node);
+        path.insert(path.begin(), node);
+        return path;
+    }
+
+    /**
+     * @brief Returns an immutable, pre-order numbered snapshot of the tree, built in O(n).
+     *
+     * The snapshot shares nothing with the tree, so later changes to the tree do
+     * not affect it and it can be read from any number of threads.
+     */
+    FrozenTree<T, N> freeze() const {
+        return FrozenTree<T, N>(root.get());
+    }
+
+    /**
+     * @brief Exports the tree as flat level-order arrays in one O(n) pass.
+     *
+     * Node values live in separate nodes, so they are copied into the result.
+     */
+    FlatTree<T> to_flat() const {
+        std::vector<T> values;
+        std::vector<size_t> parents;
+        std::vector<size_t> offsets;
+        if (root) {
+            values.reserve(node_count);
+            parents.reserve(node_count);
+            offsets.reserve(node_count + 1);
+
+            std::vector<const Node<T> *> order{root.get()};
+            order.reserve(node_count);
+            parents.push_back(FlatTree<T>::npos);
+            for (size_t i = 0; i < order.size(); ++i) {
+                values.push_back(order[i]->data);
+                offsets.push_back(order.size());
+                for (const auto &child : order[i]->children) {
+                    if (!child) continue;
+                    order.push_back(child.get());
+                    parents.push_back(i);
+                }
+            }
+            offsets.push_back(order.size());
+        }
+        return FlatTree<T>(std::move(values), std::move(parents), std::move(offsets));
+    }
+
+    /**
+     * @brief Prints the tree structure.
+     *
+     * This function prints the tree structure starting from the root.
+     * Each level of the tree is indented to visually represent the tree hierarchy.
+     */
+    void print() const {
+        printHelper(root, 0);
+    }
+    /**
+      * @brief Returns a pre-order iterator starting at the root of the tree.
+      *
+      * @return PreOrderIterator An iterator for pre-order traversal.
+      */
+    class PreOrderIterator {
+    public:
+        explicit PreOrderIterator(std::shared_ptr<Node<T>> root) {
+            if (root) {
+                stack.push(root);
+            }
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !stack.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
 
             auto node = stack.top();
             stack.pop();
 
-            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
-                if (*it) stack.push(*it);
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) stack.push(*it);
+            }
+
+            return node->data;
+        }
+
+    private:
+        std::stack<std::shared_ptr<Node<T>>> stack;
+    };
+/**
+     * @brief Returns a post-order iterator starting at the root of the tree.
+     *
+     * @return PostOrderIterator An iterator for post-order traversal.
+     */
+    class PostOrderIterator {
+    public:
+        explicit PostOrderIterator(std::shared_ptr<Node<T>> root) {
+            if (root) {
+                add_nodes(root);
+            }
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !queue.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            auto node = queue.front();
+            queue.pop();
+            return node->data;
+        }
+
+    private:
+        std::queue<std::shared_ptr<Node<T>>> queue;
+
+        void add_nodes(const std::shared_ptr<Node<T>> &node) {
+            if (!node) return;
+
+            for (const auto &child : node->children) {
+                add_nodes(child);
+            }
+            queue.push(node);
+        }
+    };
+    /**
+        * @brief Returns an in-order iterator starting at the root of the tree.
+        *
+        * @return InOrderIterator An iterator for in-order traversal.
+        */
+    class InOrderIterator {
+    public:
+        explicit InOrderIterator(std::shared_ptr<Node<T>> root) {
+            if constexpr (N == 2) {
+                push_left_spine(root.get());
+            } else {
+                add_nodes(root);
+            }
+        }
+
+        [[nodiscard]] bool has_next() const {
+            if constexpr (N == 2) {
+                return !spine.empty();
+            } else {
+                return position < nodes.size();
+            }
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            if constexpr (N == 2) {
+                Node<T> *node = spine.back();
+                spine.pop_back();
+                push_left_spine(node->right());
+                return node->data;
+            } else {
+                return nodes[position++]->data;
+            }
+        }
+
+    private:
+        std::vector<std::shared_ptr<Node<T>>> nodes;
+        size_t position = 0;
+        /// Binary trees follow the raw left/right links and keep only the current
+        /// left spine, instead of materializing the whole traversal up front.
+        std::vector<Node<T> *> spine;
+
+        void add_nodes(const std::shared_ptr<Node<T>> &node) {
+            if (!node) return;
+
+            if (!node->children.empty()) {
+                add_nodes(node->children[0]);
+            }
+
+            nodes.push_back(node);
+
+            if (node->children.size() > 1) {
+                for (size_t i = 1; i < node->children.size(); ++i) {
+                    add_nodes(node->children[i]);
+                }
+            }
+        }
+
+        void push_left_spine(Node<T> *node) {
+            for (; node; node = node->left()) spine.push_back(node);
+        }
+    };
+/**
+     * @brief Returns a BFS iterator starting at the root of the tree.
+     *
+     * @return BFSIterator An iterator for breadth-first search traversal.
+     */
+    class BFSIterator {
+    public:
+        explicit BFSIterator(std::shared_ptr<Node<T>> root) {
+            if (root) {
+                queue.push(root);
+            }
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !queue.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            auto node = queue.front();
+            queue.pop();
+
+            for (auto &child : node->children) {
+                if (child) queue.push(child);
+            }
+
+            return node->data;
+        }
+
+    private:
+        std::queue<std::shared_ptr<Node<T>>> queue;
+    };
+/**
+     * @brief Returns a DFS iterator starting at the root of the tree.
+     *
+     * @return DFSIterator An iterator for depth-first search traversal.
+     */
+    class DFSIterator {
+    public:
+        explicit DFSIterator(std::shared_ptr<Node<T>> root) {
+            if (root) {
+                stack.push(root);
+            }
+        }
+
+        [[nodiscard]] bool has_next() const {
+            return !stack.empty();
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            auto node = stack.top();
+            stack.pop();
+
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) stack.push(*it);
+            }
+
+            return node->data;
+        }
+
+    private:
+        std::stack<std::shared_ptr<Node<T>>> stack;
+    };
+
+    /**
+     * @brief Pre-order iterator that uses O(1) extra space.
+     *
+     * Walks parent links instead of keeping a stack, so it never allocates.
+     * The tree must not be modified while the iterator is in use.
+     */
+    class StacklessPreOrderIterator {
+    public:
+        explicit StacklessPreOrderIterator(const std::shared_ptr<Node<T>> &root) : start(root.get()), current(root.get()) {}
+
+        [[nodiscard]] bool has_next() const {
+            return current != nullptr;
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            Node<T> *node = current;
+            current = first_child(node);
+            for (Node<T> *up = node; !current && up != start; up = up->parent) {
+                current = next_sibling(up);
+            }
+            return node->data;
+        }
+
+    private:
+        Node<T> *start;
+        Node<T> *current;
+    };
+
+    /**
+     * @brief Post-order iterator that uses O(1) extra space.
+     *
+     * Walks parent links instead of keeping a queue, so it never allocates.
+     * The tree must not be modified while the iterator is in use.
+     */
+    class StacklessPostOrderIterator {
+    public:
+        explicit StacklessPostOrderIterator(const std::shared_ptr<Node<T>> &root)
+                : start(root.get()), current(root ? leftmost(root.get()) : nullptr) {}
+
+        [[nodiscard]] bool has_next() const {
+            return current != nullptr;
+        }
+
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            Node<T> *node = current;
+            if (node == start) {
+                current = nullptr;
+            } else {
+                Node<T> *sibling = next_sibling(node);
+                current = sibling ? leftmost(sibling) : node->parent;
             }
+            return node->data;
+        }
+
+    private:
+        Node<T> *start;
+        Node<T> *current;
+    };
+
+    /**
+     * @brief In-order iterator that uses O(1) extra space.
+     *
+     * Visits the first child's subtree, the node, then the remaining subtrees,
+     * like InOrderIterator, but walks parent links instead of materializing the order.
+     * The tree must not be modified while the iterator is in use.
+     */
+    class StacklessInOrderIterator {
+    public:
+        explicit StacklessInOrderIterator(const std::shared_ptr<Node<T>> &root)
+                : start(root.get()), current(root ? leftmost(root.get()) : nullptr) {}
+
+        [[nodiscard]] bool has_next() const {
+            return current != nullptr;
+        }
 
+        T next() {
+            if (!has_next()) throw std::out_of_range("No more elements");
+
+            Node<T> *node = current;
+            Node<T> *first = first_child(node);
+            Node<T> *second = first ? next_sibling(first) : nullptr;
+            current = second ? leftmost(second) : after_subtree(node);
             return node->data;
         }
 
     private:
-        std::stack<std::shared_ptr<Node<T>>> stack;
+        Node<T> *start;
+        Node<T> *current;
+
+        Node<T> *after_subtree(Node<T> *node) const {
+            while (node != start) {
+                Node<T> *up = node->parent;
+                if (node == first_child(up)) return up;
+                Node<T> *sibling = next_sibling(node);
+                if (sibling) return leftmost(sibling);
+                node = up;
+            }
+            return nullptr;
+        }
     };
 
     // Heap Iterator
@@ -308,6 +1318,9 @@ public:
     BFSIterator begin_bfs() { return BFSIterator(root); }
     DFSIterator begin_dfs() { return DFSIterator(root); }
     HeapIterator begin_heap() { return HeapIterator(root); }
+    StacklessPreOrderIterator begin_preorder_stackless() { return StacklessPreOrderIterator(root); }
+    StacklessPostOrderIterator begin_postorder_stackless() { return StacklessPostOrderIterator(root); }
+    StacklessInOrderIterator begin_inorder_stackless() { return StacklessInOrderIterator(root); }
     /**
         * @brief Finds a node with the given value starting from the specified node.
         *
@@ -317,6 +1330,588 @@ public:
         * @return std::shared_ptr<Node<T>> A shared pointer to the found node, or nullptr if not found.
         */
 private:
+    std::shared_ptr<NodeArena> arena = std::make_shared<NodeArena>();
+    size_t node_count = 0;
+    std::vector<size_t> level_counts; ///< Number of nodes on each level; its length gives the height.
+    bool tracking_sizes = false;
+    bool tracking_bounds = false;
+    int filter_stride = 0; ///< Levels between membership filters; 0 when filters are off.
+    double filter_bits_per_item = 0.0;
+    size_t filter_budget = 0;
+    size_t filter_memory = 0; ///< Bytes held by all filters together.
+    std::unordered_map<const Node<T> *, BloomFilter<T>> filters;
+
+    static constexpr size_t min_filter_capacity = 16;
+    static constexpr size_t parallel_build_threshold = 1'000'000;
+    static constexpr size_t parallel_clone_threshold = 1 << 16;
+    /// Arena bytes per node: the node plus the control block std::allocate_shared puts next to it.
+    static constexpr size_t node_footprint = sizeof(Node<T>) + 4 * sizeof(void *);
+
+    /**
+        * @brief Links nodes described by a validated-length parent array into this empty tree.
+        *
+        * Children are bucketed by parent with a counting pass, then the tree is
+        * created in pre-order so the nodes sit in the arena in pre-order.
+        */
+    void build_from_parents(std::span<const T> values, std::span<const std::ptrdiff_t> parents) {
+        const size_t n = values.size();
+        if (n == 0) return;
+
+        std::vector<size_t> offsets(n + 1, 0);
+        size_t root_index = n;
+        for (size_t i = 0; i < n; ++i) {
+            if (parents[i] < 0) {
+                if (root_index != n) throw std::invalid_argument("Input has more than one root.");
+                root_index = i;
+            } else if (static_cast<size_t>(parents[i]) >= n) {
+                throw std::invalid_argument("Parent index outside the values.");
+            } else if (++offsets[static_cast<size_t>(parents[i]) + 1] > static_cast<size_t>(N)) {
+                throw std::invalid_argument("Node has more than N children.");
+            }
+        }
+        if (root_index == n) throw std::invalid_argument("Input has no root.");
+
+        for (size_t i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+        std::vector<size_t> kids(n - 1);
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            if (parents[i] >= 0) kids[cursor[static_cast<size_t>(parents[i])]++] = i;
+        }
+
+        reserve_nodes(n);
+        std::vector<Node<T> *> made(n, nullptr);
+        std::vector<size_t> pending{root_index};
+        size_t built = 0;
+        while (!pending.empty()) {
+            size_t i = pending.back();
+            pending.pop_back();
+            auto node = make_node(values[i]);
+            node->children.reserve(offsets[i + 1] - offsets[i]);
+            made[i] = node.get();
+            if (parents[i] < 0) {
+                plant_root(std::move(node));
+            } else {
+                link_child(made[static_cast<size_t>(parents[i])], node);
+            }
+            ++built;
+            for (size_t k = offsets[i + 1]; k-- > offsets[i];) pending.push_back(kids[k]);
+        }
+        if (built != n) throw std::invalid_argument("Input contains a cycle.");
+    }
+
+    /**
+        * @brief Adds a value to the filters of a node and all its ancestors.
+        *
+        * A leaf on a filtered level gets a fresh filter if it has none. Other nodes
+        * without one were left out for the budget and stay so, since a filter of
+        * just this value would hide the rest of their subtree. A filter that grows
+        * past its capacity is rebuilt from its subtree at twice the size, if the
+        * budget allows.
+        */
+    void add_to_filters(Node<T> *node, const T &value) {
+        auto hash = BloomFilter<T>::hash(value);
+        for (Node<T> *up = node; up; up = up->parent) {
+            if (up->depth % filter_stride != 0) continue;
+            auto filter = filters.find(up);
+            if (filter == filters.end()) {
+                if (up != node || up->numOfChildren != 0) continue;
+                if (!filter_fits(up, BloomFilter<T>::memory_bytes_for(min_filter_capacity, filter_bits_per_item))) continue;
+                place_filter(up, BloomFilter<T>(min_filter_capacity, filter_bits_per_item));
+                filter = filters.find(up);
+            }
+            filter->second.insert(hash);
+            const size_t capacity = 2 * filter->second.size();
+            if (filter->second.size() > filter->second.capacity() &&
+                filter_fits(up, BloomFilter<T>::memory_bytes_for(capacity, filter_bits_per_item))) {
+                place_filter(up, build_filter(up, capacity, filter_bits_per_item));
+            }
+        }
+    }
+
+    /**
+        * @brief Returns whether @p node may hold a filter of @p bytes, replacing its current one, within the budget.
+        */
+    [[nodiscard]] bool filter_fits(const Node<T> *node, size_t bytes) const {
+        if (filter_budget == 0) return true;
+        auto current = filters.find(node);
+        size_t freed = current == filters.end() ? 0 : current->second.memory_bytes();
+        return filter_memory - freed + bytes <= filter_budget;
+    }
+
+    void place_filter(const Node<T> *node, BloomFilter<T> filter) {
+        drop_filter(node);
+        filter_memory += filter.memory_bytes();
+        filters.emplace(node, std::move(filter));
+    }
+
+    void drop_filter(const Node<T> *node) {
+        auto current = filters.find(node);
+        if (current == filters.end()) return;
+        filter_memory -= current->second.memory_bytes();
+        filters.erase(current);
+    }
+
+    BloomFilter<T> build_filter(Node<T> *top, size_t capacity, double bits_per_item) const {
+        BloomFilter<T> filter(std::max(capacity, min_filter_capacity), bits_per_item);
+        NoPrune prune;
+        search(top, [&](Node<T> *node) {
+            filter.insert(node->data);
+            return false;
+        }, prune);
+        return filter;
+    }
+
+    void rebuild_filters() {
+        filters.clear();
+        filter_memory = 0;
+        if (!root) return;
+
+        std::vector<Node<T> *> order;
+        preorder_layout(order);
+        std::unordered_map<const Node<T> *, size_t> sizes;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            size_t size = 1;
+            for (const auto &child : (*it)->children) {
+                if (child) size += sizes[child.get()];
+            }
+            sizes[*it] = size;
+        }
+        if (filter_budget > 0) fit_filters_to_budget(order, sizes);
+
+        for (auto *node : order) {
+            if (node->depth % filter_stride != 0) continue;
+            const size_t capacity = std::max(2 * sizes[node], min_filter_capacity);
+            if (filter_fits(node, BloomFilter<T>::memory_bytes_for(capacity, filter_bits_per_item))) {
+                place_filter(node, build_filter(node, capacity, filter_bits_per_item));
+            }
+        }
+    }
+
+    /**
+        * @brief Lowers the bits per item, down to one, and then doubles the stride until all filters fit the budget.
+        *
+        * Stops at a stride that leaves only the root filtered; if even that filter
+        * does not fit, rebuild_filters() builds none.
+        */
+    void fit_filters_to_budget(const std::vector<Node<T> *> &order, const std::unordered_map<const Node<T> *, size_t> &sizes) {
+        const auto height = static_cast<int>(level_counts.size()) - 1;
+        for (;;) {
+            size_t count = 0;
+            size_t capacity = 0;
+            for (auto *node : order) {
+                if (node->depth % filter_stride != 0) continue;
+                ++count;
+                capacity += std::max(2 * sizes.at(node), min_filter_capacity);
+            }
+            // Rounding up to whole words costs each filter at most 9 bytes over capacity * bits / 8.
+            if (filter_budget > 9 * count) {
+                double affordable = static_cast<double>(filter_budget - 9 * count) * 8.0 / static_cast<double>(capacity);
+                if (affordable >= 1.0) {
+                    filter_bits_per_item = std::min(filter_bits_per_item, affordable);
+                    return;
+                }
+            }
+            if (filter_stride > height) return;
+            filter_stride *= 2;
+        }
+    }
+
+    /**
+        * @brief Recomputes a node's bounds from its value and its children's bounds.
+        *
+        * @return bool Whether the bounds changed.
+        */
+    static bool refresh_bounds(Node<T> *node) {
+        auto fresh = SubtreeBounds<T>(node->data);
+        for (const auto &child : node->children) {
+            if (!child) continue;
+            fresh.min = std::min(fresh.min, child->bounds.min);
+            fresh.max = std::max(fresh.max, child->bounds.max);
+        }
+        bool changed = fresh.min != node->bounds.min || fresh.max != node->bounds.max;
+        node->bounds = fresh;
+        return changed;
+    }
+
+    void refresh_bounds_upwards(Node<T> *node) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (tracking_bounds) {
+                for (Node<T> *up = node; up && refresh_bounds(up); up = up->parent) {}
+            }
+        }
+    }
+
+    static bool widen_bounds(Node<T> *node, const T &value) {
+        if (value < node->bounds.min) {
+            node->bounds.min = value;
+            return true;
+        }
+        if (node->bounds.max < value) {
+            node->bounds.max = value;
+            return true;
+        }
+        return false;
+    }
+
+    std::shared_ptr<Node<T>> make_node(T value) {
+        if (!arena) arena = std::make_shared<NodeArena>();
+        return std::allocate_shared<Node<T>>(ArenaAllocator<Node<T>>(arena), std::move(value));
+    }
+
+    void reserve_nodes(size_t count) {
+        if (!arena) arena = std::make_shared<NodeArena>();
+        arena->reserve(count * node_footprint);
+    }
+
+    /**
+        * @brief Copies everything below @p top in pre-order into @p into, without recursion.
+        *
+        * Subtrees listed in @p done are not walked; their already cloned copies are linked in instead.
+        */
+    static std::shared_ptr<Node<T>> clone_subtree(const Node<T> *top, const std::shared_ptr<NodeArena> &into,
+                                                  const std::unordered_map<const Node<T> *, std::shared_ptr<Node<T>>> &done = {}) {
+        std::shared_ptr<Node<T>> copy_of_top;
+        std::vector<std::pair<const Node<T> *, Node<T> *>> pending{{top, nullptr}};
+        while (!pending.empty()) {
+            auto [source, parent] = pending.back();
+            pending.pop_back();
+
+            std::shared_ptr<Node<T>> copy;
+            auto cloned = source == top ? done.end() : done.find(source);
+            if (cloned != done.end()) {
+                copy = cloned->second;
+            } else {
+                copy = std::allocate_shared<Node<T>>(ArenaAllocator<Node<T>>(into), source->data);
+                copy->depth = source->depth;
+                copy->subtree_size = source->subtree_size;
+                copy->bounds = source->bounds;
+                copy->children.reserve(source->children.size());
+                for (auto it = source->children.rbegin(); it != source->children.rend(); ++it) {
+                    if (*it) pending.emplace_back(it->get(), copy.get());
+                }
+            }
+
+            if (!parent) {
+                copy_of_top = std::move(copy);
+                continue;
+            }
+            if constexpr (N == 2) {
+                parent->links[static_cast<size_t>(parent->numOfChildren)] = copy.get();
+            }
+            copy->parent = parent;
+            parent->children.push_back(std::move(copy));
+            parent->numOfChildren++;
+        }
+        return copy_of_top;
+    }
+
+    void copy_nodes(const Tree &other, unsigned threads) {
+        if (!other.root) return;
+        if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+        root = clone_nodes(other.root.get(), threads);
+        if (filter_stride > 0) copy_filters(other);
+    }
+
+    /**
+        * @brief Deep-copies the tree below @p source into this tree's storage.
+        *
+        * With more than one thread, the subtrees below the first level that is wide
+        * enough are cloned by workers into arenas of their own, then the levels
+        * above them are cloned on the calling thread and the copies linked in.
+        */
+    std::shared_ptr<Node<T>> clone_nodes(const Node<T> *source, unsigned threads) {
+        std::vector<const Node<T> *> frontier{source};
+        while (threads > 1 && frontier.size() < 4 * threads) {
+            std::vector<const Node<T> *> next;
+            for (const auto *node : frontier) {
+                for (const auto &child : node->children) {
+                    if (child) next.push_back(child.get());
+                }
+            }
+            if (next.empty()) break;
+            frontier = std::move(next);
+        }
+        if (frontier.size() == 1) {
+            reserve_nodes(node_count);
+            return clone_subtree(source, arena);
+        }
+
+        std::vector<std::shared_ptr<Node<T>>> copies(frontier.size());
+        std::atomic<size_t> next_subtree{0};
+        auto worker = [&] {
+            auto local = std::make_shared<NodeArena>();
+            for (size_t i = next_subtree++; i < frontier.size(); i = next_subtree++) {
+                copies[i] = clone_subtree(frontier[i], local);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads && i < frontier.size(); ++i) workers.emplace_back(worker);
+        worker();
+        for (auto &thread : workers) thread.join();
+
+        std::unordered_map<const Node<T> *, std::shared_ptr<Node<T>>> done;
+        done.reserve(frontier.size());
+        for (size_t i = 0; i < frontier.size(); ++i) done.emplace(frontier[i], std::move(copies[i]));
+        return clone_subtree(source, arena, done);
+    }
+
+    /**
+        * @brief Copies the membership filters of @p other onto the matching nodes of this tree.
+        *
+        * Walks both trees in lockstep; right after cloning they have the same shape,
+        * except that the copy has no null child slots.
+        */
+    void copy_filters(const Tree &other) {
+        std::vector<std::pair<const Node<T> *, const Node<T> *>> pending{{other.root.get(), root.get()}};
+        while (!pending.empty()) {
+            auto [source, copy] = pending.back();
+            pending.pop_back();
+            if (source->depth % filter_stride == 0) {
+                auto filter = other.filters.find(source);
+                if (filter != other.filters.end()) place_filter(copy, filter->second);
+            }
+            size_t next = 0;
+            for (const auto &child : source->children) {
+                if (child) pending.emplace_back(child.get(), copy->children[next++].get());
+            }
+        }
+    }
+
+    static Node<T> *first_child(const Node<T> *node) {
+        if constexpr (N == 2) {
+            return node->left();
+        } else {
+            for (const auto &child : node->children) {
+                if (child) return child.get();
+            }
+            return nullptr;
+        }
+    }
+
+    static Node<T> *next_sibling(const Node<T> *node) {
+        const Node<T> *parent = node->parent;
+        if (!parent) return nullptr;
+        if constexpr (N == 2) {
+            return node == parent->left() ? parent->right() : nullptr;
+        } else {
+            bool found = false;
+            for (const auto &child : parent->children) {
+                if (found && child) return child.get();
+                if (child.get() == node) found = true;
+            }
+            return nullptr;
+        }
+    }
+
+    static Node<T> *leftmost(Node<T> *node) {
+        for (Node<T> *first = first_child(node); first; first = first_child(node)) node = first;
+        return node;
+    }
+
+    void plant_root(std::shared_ptr<Node<T>> node) {
+        filters.clear();
+        filter_memory = 0;
+        delete_tree(std::move(root));
+        root = std::move(node);
+        node_count = 1;
+        level_counts.assign(1, 1);
+        if constexpr (Hashable<T>) {
+            if (filter_stride > 0) rebuild_filters();
+        }
+    }
+
+    void require_member(const Node<T> *node) const {
+        if (!node) throw std::invalid_argument("Node is null.");
+        const Node<T> *top = node;
+        while (top->parent) top = top->parent;
+        if (top != root.get()) throw std::invalid_argument("Node is not in this tree.");
+    }
+
+    /**
+        * @brief Returns the position of a non-root node in its parent's children.
+        */
+    static auto child_slot(const Node<T> *node) {
+        auto &siblings = node->parent->children;
+        return std::find_if(siblings.begin(), siblings.end(),
+                            [&](const std::shared_ptr<Node<T>> &child) { return child.get() == node; });
+    }
+
+    /**
+        * @brief Re-derives the left/right links of a binary node from its children.
+        */
+    static void sync_links(Node<T> *node) {
+        if constexpr (N == 2) {
+            for (size_t side = 0; side < 2; ++side) {
+                node->links[side] = side < node->children.size() ? node->children[side].get() : nullptr;
+            }
+        }
+    }
+
+    /**
+        * @brief Detaches a node from its parent, or the root from the tree, and hands over its ownership.
+        */
+    std::shared_ptr<Node<T>> unlink(Node<T> *node) {
+        if (node == root.get()) return std::move(root);
+
+        Node<T> *parent = node->parent;
+        auto slot = child_slot(node);
+        auto detached = std::move(*slot);
+        parent->children.erase(slot);
+        parent->numOfChildren--;
+        sync_links(parent);
+        node->parent = nullptr;
+        return detached;
+    }
+
+    /**
+        * @brief Unlinks a subtree and takes its nodes out of this tree's bookkeeping.
+        *
+        * @param nodes Receives the nodes of the subtree in pre-order.
+        *
+        * @return std::shared_ptr<Node<T>> The now parentless subtree root.
+        */
+    std::shared_ptr<Node<T>> detach(Node<T> *node, std::vector<Node<T> *> &nodes) {
+        NoPrune prune;
+        search(node, [&](Node<T> *below) {
+            nodes.push_back(below);
+            return false;
+        }, prune);
+        for (auto *below : nodes) {
+            --level_counts[static_cast<size_t>(below->depth)];
+            drop_filter(below);
+        }
+        node_count -= nodes.size();
+        trim_levels();
+
+        Node<T> *parent = node->parent;
+        auto detached = unlink(node);
+        if (parent) {
+            if (tracking_sizes) {
+                for (Node<T> *up = parent; up; up = up->parent) up->subtree_size -= nodes.size();
+            }
+            refresh_bounds_upwards(parent);
+        }
+        return detached;
+    }
+
+    /**
+        * @brief Links a detached subtree as the last child of @p parent and accounts for its nodes.
+        *
+        * @param nodes The nodes of the subtree in pre-order, as produced by detach().
+        */
+    void attach(Node<T> *parent, std::shared_ptr<Node<T>> subtree, const std::vector<Node<T> *> &nodes) {
+        Node<T> *top = subtree.get();
+        if constexpr (N == 2) {
+            parent->links[static_cast<size_t>(parent->numOfChildren)] = top;
+        }
+        parent->children.push_back(std::move(subtree));
+        parent->numOfChildren++;
+        top->parent = parent;
+
+        const int shift = parent->depth + 1 - top->depth;
+        for (auto *below : nodes) {
+            below->depth += shift;
+            const auto level = static_cast<size_t>(below->depth);
+            if (level >= level_counts.size()) level_counts.resize(level + 1, 0);
+            ++level_counts[level];
+        }
+        node_count += nodes.size();
+
+        if (tracking_sizes) {
+            for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+                (*it)->subtree_size = 1;
+                for (const auto &child : (*it)->children) {
+                    if (child) (*it)->subtree_size += child->subtree_size;
+                }
+            }
+            for (Node<T> *up = parent; up; up = up->parent) up->subtree_size += nodes.size();
+        }
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (tracking_bounds) {
+                for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) refresh_bounds(*it);
+                for (Node<T> *up = parent; up; up = up->parent) {
+                    bool widened = widen_bounds(up, top->bounds.min);
+                    if (!(widen_bounds(up, top->bounds.max) || widened)) break;
+                }
+            }
+        }
+        if constexpr (Hashable<T>) {
+            if (filter_stride > 0) attach_filters(parent, nodes);
+        }
+    }
+
+    /**
+        * @brief Gives the nodes of an attached subtree their filters and adds its values to the ancestors' ones.
+        */
+    void attach_filters(Node<T> *parent, const std::vector<Node<T> *> &nodes) {
+        std::unordered_map<const Node<T> *, size_t> sizes;
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+            size_t size = 1;
+            for (const auto &child : (*it)->children) {
+                if (child) size += sizes[child.get()];
+            }
+            sizes[*it] = size;
+        }
+        for (auto *below : nodes) {
+            if (below->depth % filter_stride != 0) continue;
+            const size_t capacity = std::max(2 * sizes[below], min_filter_capacity);
+            if (filter_fits(below, BloomFilter<T>::memory_bytes_for(capacity, filter_bits_per_item))) {
+                place_filter(below, build_filter(below, capacity, filter_bits_per_item));
+            }
+        }
+        for (auto *below : nodes) add_to_filters(parent, below->data);
+    }
+
+    void trim_levels() {
+        while (!level_counts.empty() && level_counts.back() == 0) level_counts.pop_back();
+    }
+
+    void link_child(Node<T> *parent, const std::shared_ptr<Node<T>> &child) {
+        if constexpr (N == 2) {
+            parent->links[static_cast<size_t>(parent->numOfChildren)] = child.get();
+        }
+        parent->children.push_back(child);
+        parent->numOfChildren++;
+        child->parent = parent;
+        child->depth = parent->depth + 1;
+
+        ++node_count;
+        const auto level = static_cast<size_t>(child->depth);
+        if (level == level_counts.size()) level_counts.push_back(0);
+        ++level_counts[level];
+        if (tracking_sizes) {
+            for (Node<T> *up = parent; up; up = up->parent) ++up->subtree_size;
+        }
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (tracking_bounds) {
+                for (Node<T> *up = parent; up && widen_bounds(up, child->data); up = up->parent) {}
+            }
+        }
+        if constexpr (Hashable<T>) {
+            if (filter_stride > 0) add_to_filters(child.get(), child->data);
+        }
+    }
+
+    /**
+        * @brief Pre-order walk below @p start that skips pruned subtrees.
+        *
+        * @param visit Called with each visited node; returning true stops the walk.
+        */
+    template<typename Visit, typename Prune>
+    static void search(Node<T> *start, Visit &&visit, Prune &prune) {
+        std::vector<Node<T> *> pending;
+        if (start) pending.push_back(start);
+        while (!pending.empty()) {
+            Node<T> *node = pending.back();
+            pending.pop_back();
+            if (prune(*node)) continue;
+            if (visit(node)) return;
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) pending.push_back(it->get());
+            }
+        }
+    }
+
     std::shared_ptr<Node<T>> find_node(const std::shared_ptr<Node<T>> &node, const T &value) const {
         if (!node) return nullptr;
         if (node->data == value) return node;
@@ -341,11 +1936,92 @@ private:
         }
     }
 
-    void delete_tree(const std::shared_ptr<Node<T>> &node) {
-        if (!node) return;
+    void preorder_layout(std::vector<Node<T> *> &order) const {
+        std::stack<Node<T> *> pending;
+        pending.push(root.get());
+        while (!pending.empty()) {
+            auto *node = pending.top();
+            pending.pop();
+            order.push_back(node);
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                if (*it) pending.push(it->get());
+            }
+        }
+    }
+
+    void bfs_layout(std::vector<Node<T> *> &order) const {
+        order.push_back(root.get());
+        for (size_t i = 0; i < order.size(); ++i) {
+            for (const auto &child : order[i]->children) {
+                if (child) order.push_back(child.get());
+            }
+        }
+    }
+
+    int tree_levels() const {
+        int levels = 0;
+        std::vector<Node<T> *> level{root.get()};
+        while (!level.empty()) {
+            ++levels;
+            level = next_level(level);
+        }
+        return levels;
+    }
+
+    static std::vector<Node<T> *> next_level(const std::vector<Node<T> *> &level) {
+        std::vector<Node<T> *> next;
+        for (auto *node : level) {
+            for (const auto &child : node->children) {
+                if (child) next.push_back(child.get());
+            }
+        }
+        return next;
+    }
+
+    /**
+        * @brief Appends the van Emde Boas order of the top @p levels levels below @p node.
+        *
+        * The top half of the levels is laid out first, followed by each subtree
+        * hanging off its bottom, each of them recursively in the same way.
+        */
+    static void veb_layout(Node<T> *node, int levels, std::vector<Node<T> *> &order) {
+        if (levels == 1) {
+            order.push_back(node);
+            return;
+        }
+
+        int top = levels / 2;
+        veb_layout(node, top, order);
+
+        std::vector<Node<T> *> frontier{node};
+        for (int i = 0; i < top && !frontier.empty(); ++i) {
+            frontier = next_level(frontier);
+        }
+        for (auto *bottom : frontier) {
+            veb_layout(bottom, levels - top, order);
+        }
+    }
 
-        for (auto &child : node->children) {
-            delete_tree(child);
+    /**
+        * @brief Releases a subtree without recursion, so deep trees cannot overflow the stack.
+        *
+        * A node that is still shared elsewhere, for example by an iterator or a copy
+        * of the tree, is left intact together with everything below it.
+        */
+    static void delete_tree(std::shared_ptr<Node<T>> node) {
+        std::vector<std::shared_ptr<Node<T>>> pending;
+        if (node) pending.push_back(std::move(node));
+        while (!pending.empty()) {
+            auto current = std::move(pending.back());
+            pending.pop_back();
+            if (current.use_count() != 1) {
+                current->parent = nullptr;
+                continue;
+            }
+            for (auto &child : current->children) {
+                if (child) pending.push_back(std::move(child));
+            }
+            current->children.clear();
         }
     }
 };